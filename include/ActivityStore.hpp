@@ -0,0 +1,163 @@
+//ActivityStore.hpp
+#pragma once
+#include "models.hpp"
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ActivityStore;
+
+// Newest-first window onto an ActivityStore. Like RecordView it copies
+// nothing and stays valid only until the next activity is logged.
+class ActivityView
+{
+public:
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Activity;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Activity*;
+        using reference = const Activity&;
+
+        const_iterator(const ActivityView* view, size_t index) : view_(view), index_(index) {}
+
+        reference operator*() const { return (*view_)[index_]; }
+        pointer operator->() const { return &(*view_)[index_]; }
+        const_iterator& operator++() { ++index_; return *this; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const ActivityView* view_;
+        size_t index_;
+    };
+
+    ActivityView() = default;
+    // Covers store positions [first, last), presented from last - 1 down
+    ActivityView(const ActivityStore& store, size_t first, size_t last)
+        : store_(&store), first_(first), last_(last) {}
+
+    size_t size() const { return last_ - first_; }
+    bool empty() const { return first_ == last_; }
+    const Activity& operator[](size_t index) const;
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    const ActivityStore* store_ = nullptr;
+    size_t first_ = 0;
+    size_t last_ = 0;
+};
+
+// In-memory activity log of one project, bounded in size. The newest
+// entries live in a fixed-capacity ring; each entry the ring overwrites
+// spills into a batch, and every kArchiveBatch spilled entries seal into a
+// batch that the next save writes to the on-disk archive. Once the archive
+// write is confirmed the batch is dropped, so memory and snapshot size
+// stay flat however long the project lives.
+//
+// Iteration and indexing cover every entry still held in memory, oldest
+// first: sealed batches, the open batch, then the ring. Entries are kept in
+// id order with non-decreasing timestamps, so every query below is a
+// binary search plus a walk, never a sort.
+class ActivityStore
+{
+public:
+    static constexpr size_t kDefaultCapacity = 1000;
+    static constexpr size_t kArchiveBatch = 4096;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Activity;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Activity*;
+        using reference = const Activity&;
+
+        const_iterator(const ActivityStore* store, size_t index) : store_(store), index_(index) {}
+
+        reference operator*() const { return (*store_)[index_]; }
+        pointer operator->() const { return &(*store_)[index_]; }
+        const_iterator& operator++() { ++index_; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++index_; return old; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const ActivityStore* store_;
+        size_t index_;
+    };
+
+    void setCapacity(size_t entries);
+    size_t capacity() const { return capacity_; }
+
+    void push_back(Activity activity);
+    void assign(std::vector<Activity>&& entries);
+    void clear();
+
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+    const Activity& operator[](size_t index) const;
+    const Activity& back() const { return (*this)[size() - 1]; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // Newest first, without touching anything older than the limit
+    ActivityView recent(size_t limit) const;
+
+    // Entries with from <= timestamp < to, newest first
+    ActivityView between(time_t from, time_t to) const;
+
+    // Newest entries about one ticket, from a per-ticket index of ids
+    std::vector<Activity> forTicket(int ticket_id, size_t limit) const;
+
+    // Position of the first entry with an id >= id
+    size_t lowerBound(int id) const;
+
+    // Full batches waiting for the archive, oldest first
+    const std::deque<std::vector<Activity>>& sealedBatches() const { return sealed_; }
+
+    // Forgets sealed batches whose entries all have ids <= through_id
+    void dropArchived(int through_id);
+
+private:
+    void spill(Activity&& activity);
+    const Activity& ringAt(size_t index) const { return ring_[(head_ + index) % ring_.size()]; }
+
+    template <typename Less>
+    size_t partitionPoint(Less less) const;
+
+    size_t capacity_ = kDefaultCapacity;
+    std::vector<Activity> ring_;
+    size_t head_ = 0;   // oldest ring entry once the ring is full
+    std::vector<Activity> open_batch_;
+    std::deque<std::vector<Activity>> sealed_;
+
+    // ticket id -> ids of its entries still in memory, ascending
+    std::unordered_map<int, std::deque<int>> by_ticket_;
+};
+
+inline const Activity& ActivityView::operator[](size_t index) const
+{
+    return (*store_)[last_ - 1 - index];
+}
+
+// Sealed activity batches on disk, one binary snapshot file per batch:
+// projects/<name>.archive/activities-<first id>.rsp. Files are written
+// once and never modified.
+class ActivityArchive
+{
+public:
+    static std::string encodeBatch(const std::vector<Activity>& batch);
+    static std::string batchFileName(const std::vector<Activity>& batch);
+
+    // First ids of the archived batches, ascending
+    static std::vector<int> listBatches(const std::string& directory);
+    static bool loadBatch(const std::string& directory, int first_id, std::vector<Activity>& out);
+};
@@ -0,0 +1,16 @@
+//AtomicFile.hpp
+#pragma once
+#include <string>
+
+// Crash-safe whole-file replacement. The bytes go to a sibling temp file
+// that is flushed to disk and then renamed over the target, so a reader (or
+// a crash) only ever sees the old contents or the complete new ones.
+class AtomicFile
+{
+public:
+    static bool write(const std::string& path, const std::string& bytes);
+
+    // Persists the directory entry of a file just created or renamed at
+    // `path`; a no-op on Windows, where the rename is made write-through
+    static void syncDirectory(const std::string& path);
+};
@@ -0,0 +1,78 @@
+//BinarySnapshot.hpp
+#pragma once
+#include "ProjectData.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Compact project snapshot (projects/<name>.rsp). Layout, all integers
+// little-endian:
+//
+//   header        magic "RSCRUMPJ", u32 version, u32 reserved,
+//                 i32 next_{user,ticket,sprint,activity}_id,
+//                 u64 offsets of the sections below
+//   strings       u32 count, u32 offsets[count + 1], UTF-8 blob
+//   users         u32 count, fixed-size records
+//   tickets       u32 count, fixed-size records
+//   sprints       u32 count, fixed-size records
+//   activities    u32 count, fixed-size records
+//   ticket index  u32 count, (i32 id, u32 slot) sorted by id   (version 2+)
+//
+// Every string field is an index into the deduplicated string table, so
+// records are fixed-size and repeated values (status, role, ...) are stored
+// once. Fixed-size records plus the ticket index let a mapped snapshot serve
+// single tickets without decoding the rest.
+class BinarySnapshot
+{
+public:
+    static constexpr uint32_t kVersion = 2;
+
+    static std::string encode(const ProjectData& data);
+    static bool decode(const char* bytes, size_t size, ProjectData& data);
+
+    static bool save(const std::string& path, const ProjectData& data);
+    static bool load(const std::string& path, ProjectData& data);
+
+    // Maps the file and decodes everything except tickets, which are left
+    // in data.lazy_tickets to be decoded on access. Returns false for
+    // snapshots without a ticket index; use load() for those.
+    static bool loadLazy(const std::string& path, ProjectData& data);
+
+    // True when the file starts with the snapshot magic
+    static bool isBinarySnapshot(const std::string& path);
+};
+
+// Resolves string-table ids in an encoded snapshot
+class SnapshotStringTable
+{
+public:
+    bool open(const char* bytes, size_t size, uint64_t offset, uint64_t end);
+    bool get(uint32_t id, std::string& out) const;
+
+private:
+    const char* bytes_ = nullptr;
+    uint32_t count_ = 0;
+    uint64_t offsets_ = 0;
+    uint64_t blob_ = 0;
+    uint64_t blob_size_ = 0;
+};
+
+// Tickets of a memory-mapped snapshot, decoded one at a time on demand
+class LazyTicketTable
+{
+public:
+    LazyTicketTable(std::unique_ptr<MappedFile> file, const SnapshotStringTable& strings,
+                    uint64_t tickets_offset, uint32_t count, uint64_t index_offset);
+
+    size_t size() const { return count_; }
+    bool ticketAt(size_t slot, Ticket& out) const;
+    bool findTicket(int id, Ticket& out) const;
+
+private:
+    std::unique_ptr<MappedFile> file_;
+    SnapshotStringTable strings_;
+    uint64_t first_record_;
+    uint32_t count_;
+    uint64_t first_index_entry_;
+};
@@ -0,0 +1,21 @@
+//ChangeEvent.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// What a DatabaseManager change notification is about. Project covers
+// replacing the whole data set: a project switch, reload or import.
+enum class ChangeEntity : uint8_t { User, Ticket, Sprint, Activity, Project };
+constexpr size_t kChangeEntityCount = 5;
+
+enum class ChangeKind : uint8_t { Created, Updated, Deleted, Reloaded };
+
+struct ChangeEvent
+{
+    ChangeEntity entity;
+    ChangeKind kind;
+    // Record id; 0 for a project reload
+    int id;
+    // The entity's version counter once the change is applied
+    uint64_t version;
+};
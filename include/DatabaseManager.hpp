@@ -1,22 +1,71 @@
-//DatabaseManager.hpp
+﻿//DatabaseManager.hpp
 #pragma once
 #include "models.hpp"
+#include "ChangeEvent.hpp"
+#include "RecordView.hpp"
+#include "ProjectData.hpp"
+#include "ProjectSnapshot.hpp"
+#include "ProjectJournal.hpp"
+#include "SaveWorker.hpp"
+#include "TicketQuery.hpp"
 #include <vector>
 #include <string>
 #include <memory>
 #include <map>
+#include <array>
+#include <functional>
 #include <fstream>
+#include <mutex>
+#include <shared_mutex>
 
 // Use the EXACT path to your json.hpp file
 #include "../external/nlohmann/json/single_include/nlohmann/json.hpp"
 using json = nlohmann::json;
 
+// Ticket enums keep their string form in JSON; unknown text maps to the
+// first entry of each list
+NLOHMANN_JSON_SERIALIZE_ENUM(TicketStatus, {
+    {TicketStatus::Todo, "todo"}, {TicketStatus::InProgress, "in_progress"},
+    {TicketStatus::Review, "review"}, {TicketStatus::Done, "done"}})
+NLOHMANN_JSON_SERIALIZE_ENUM(TicketPriority, {
+    {TicketPriority::Medium, "medium"}, {TicketPriority::Low, "low"},
+    {TicketPriority::High, "high"}, {TicketPriority::Critical, "critical"}})
+NLOHMANN_JSON_SERIALIZE_ENUM(TicketType, {
+    {TicketType::Task, "task"}, {TicketType::Bug, "bug"},
+    {TicketType::Feature, "feature"}, {TicketType::Story, "story"}})
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(User, id, username, password, role, created_at)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Ticket, id, title, description, status, priority, type,
+                                   assignee_id, sprint_id, story_points, created_at, updated_at)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Sprint, id, name, goal, start_date, end_date, status)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Activity, id, ticket_id, user_id, action, description, timestamp)
+
+// Thread safety: any number of threads may read at once; a write waits
+// for them and then runs alone. Calls that return copies are safe from any
+// thread. Views, columns and the tickets a query visitor sees are valid
+// only until the next write, so only the thread that makes the writes (the
+// UI) should hold on to them. Readers that need one consistent version
+// across many calls take a ProjectSnapshot instead.
 class DatabaseManager {
 public:
     static DatabaseManager& getInstance();
     
+    // Snapshots are encoded on the calling thread and written atomically by
+    // a background thread. saveProject() waits for the write; the async
+    // variant returns as soon as it is queued.
     bool saveProject(const std::string& project_name);
+    bool saveProjectAsync(const std::string& project_name);
     bool loadProject(const std::string& project_name);
+    SaveStats getSaveStats() const;
+
+    // loadProject() in two steps, so the slow one can run off the UI
+    // thread. readProject() decodes a project from disk into `data` and
+    // touches nothing else in DatabaseManager; with `materialize` it also
+    // decodes every ticket of a mapped snapshot up front. installProject()
+    // then adopts the result, replacing any copy already loaded.
+    bool readProject(const std::string& project_name, ProjectData& data, bool materialize) const;
+    void installProject(const std::string& project_name, ProjectData data);
+    bool isProjectLoaded(const std::string& project_name) const;
 
     bool initialize(const std::string& db_path = "");
     bool initializeDemoData();
@@ -25,10 +74,27 @@ public:
     std::vector<std::string> getAvailableProjects();
     std::string getCurrentProjectName() const;
 
+    // Snapshot format: chosen per project, auto-detected on load. JSON stays
+    // available for import/export.
+    bool setProjectFormat(const std::string& project_name, SnapshotFormat format);
+    void setDefaultProjectFormat(SnapshotFormat format);
+    // Exports include the activities moved to the project's archive
+    bool exportProjectJson(const std::string& project_name, const std::string& file_path);
+    bool importProjectJson(const std::string& project_name, const std::string& file_path);
+
+    // Binary projects are memory-mapped on load and tickets decoded on first
+    // access; getTicket(), getTicketsInRange() and visitTickets() never force
+    // the rest in
+    void setLazyLoading(bool enabled);
+
+    // The journal is folded into a fresh snapshot once it holds this many records
+    void setJournalCompactionThreshold(size_t records);
+
     // User operations
     bool createUser(const User& user);
     User getUser(int id);
     std::vector<User> getAllUsers();
+    RecordView<User> getUsersView() const;
     bool updateUser(const User& user);
     bool deleteUser(int id);
 
@@ -36,7 +102,35 @@ public:
     bool createTicket(Ticket& ticket);
     Ticket getTicket(int id);
     std::vector<Ticket> getAllTickets();
+    RecordView<Ticket> getTicketsView() const;
+    size_t getTicketCount() const;
+    std::vector<Ticket> getTicketsInRange(size_t first, size_t count) const;
+    // Hands every ticket to `visit` in list order, under one read lock, until
+    // it returns false. Reads a lazy project's mapping a ticket at a time and
+    // builds no snapshot tables. `visit` must not write.
+    void visitTickets(const TicketQuery::Visitor& visit) const;
+    // Runs a query against the current project, handing each match to
+    // `visit` without collecting them first. `visit` runs under the read
+    // lock and must not write.
+    void queryTickets(const TicketQuery& query, const TicketQuery::Visitor& visit);
+    std::vector<Ticket> queryTickets(const TicketQuery& query);
+    // At most page_size tickets of `query`; continue with
+    // query.after(page.next). Unordered queries are paged in id order.
+    TicketPage queryTicketPage(const TicketQuery& query, size_t page_size);
     std::vector<Ticket> getTicketsBySprint(int sprint_id);
+    std::vector<Ticket> getTicketsByStatus(TicketStatus status);
+    std::vector<Ticket> getTicketsByAssignee(int assignee_id);
+    // Case-insensitive AND of the query terms over title and description;
+    // "term*" matches by prefix. Title matches rank first.
+    std::vector<Ticket> searchTickets(const std::string& query, size_t limit = SIZE_MAX);
+    // Case-insensitive substring match on title or description, in id order
+    std::vector<Ticket> searchTicketsSubstring(const std::string& fragment, size_t limit = SIZE_MAX);
+    // Tickets containing a string within max_edits edits of the fragment,
+    // closest first
+    std::vector<Ticket> searchTicketsFuzzy(const std::string& fragment, int max_edits, size_t limit = SIZE_MAX);
+    // Scalar ticket fields as contiguous columns for aggregate scans; same
+    // validity rules as a RecordView
+    const TicketColumns& getTicketColumns() const;
     bool updateTicket(const Ticket& ticket);
     bool deleteTicket(int id);
 
@@ -44,21 +138,112 @@ public:
     bool createSprint(Sprint& sprint);
     Sprint getSprint(int id);
     std::vector<Sprint> getAllSprints();
+    RecordView<Sprint> getSprintsView() const;
     bool updateSprint(const Sprint& sprint);
     bool deleteSprint(int id);
 
-    // Activity operations
+    // Activity operations. Only the newest entries stay in memory; older
+    // ones move to projects/<name>.archive as the project is saved.
+    // getActivityHistory() pages back through both, newest first. The
+    // views and the per-ticket query cover the in-memory entries.
     bool logActivity(const Activity& activity);
     std::vector<Activity> getRecentActivities(int limit = 50);
+    ActivityView getRecentActivitiesView(int limit = 50) const;
+    ActivityView getActivitiesBetween(time_t from, time_t to) const;
+    std::vector<Activity> getTicketActivities(int ticket_id, int limit = 50);
+    std::vector<Activity> getActivityHistory(int before_id, int limit = 50);
+    void setActivityRingCapacity(size_t entries);
+
+    // Immutable version of the current project for long reads, usable
+    // without the lock. The first call copies every record into shared
+    // tables; after that taking one is O(1) and each write copies only the
+    // chunks it touches while a snapshot still holds them.
+    ProjectSnapshot takeSnapshot() const;
+
+    // Change tracking. Every entity has a counter that grows with each
+    // change to it; a project reload advances them all. Listeners hear of
+    // a write's changes once it is complete and its lock released, on the
+    // thread that made it, which need not be theirs; they may read from
+    // DatabaseManager but not write to it.
+    using ChangeListener = std::function<void(const ChangeEvent&)>;
+    uint64_t getVersion(ChangeEntity entity) const;
+    int subscribe(ChangeListener listener);
+    void unsubscribe(int subscription);
 
     // Add this destructor
     ~DatabaseManager();
 
 private:
     DatabaseManager() = default;
+
+    // Guards for mutex_. They nest on one thread, so a write may call other
+    // reads and writes; only the outermost guard locks. A read cannot turn
+    // into a write. Change events raised under a WriteLock are delivered
+    // when the outermost one is released.
+    class ReadLock
+    {
+    public:
+        explicit ReadLock(const DatabaseManager& db);
+        ReadLock(ReadLock&& other) noexcept;
+        ~ReadLock();
+        ReadLock(const ReadLock&) = delete;
+        ReadLock& operator=(const ReadLock&) = delete;
+        ReadLock& operator=(ReadLock&&) = delete;
+
+    private:
+        // Null once moved from
+        const DatabaseManager* db_;
+        bool locked_;
+    };
+
+    class WriteLock
+    {
+    public:
+        explicit WriteLock(const DatabaseManager& db);
+        ~WriteLock();
+        WriteLock(const WriteLock&) = delete;
+        WriteLock& operator=(const WriteLock&) = delete;
+
+    private:
+        const DatabaseManager& db_;
+        bool locked_;
+    };
+
+    // Lazily built ticket structures a read depends on
+    struct TicketNeeds
+    {
+        // Tickets moved out of a lazily mapped snapshot; off for reads
+        // that page through the mapping or only walk users and sprints
+        bool decoded = true;
+        bool trigram = false;
+        bool search = false;
+        TicketQuery::Order order = TicketQuery::Order::None;
+        // ProjectData::tables, which covers every record
+        bool tables = false;
+    };
+    // A read lock under which the current project's tickets are decoded,
+    // its tables hold no tombstones and `needs` exist; anything missing is
+    // built under a write lock first
+    ReadLock readTickets(const TicketNeeds& needs) const;
+    // The same without decoding tickets, for reads that walk a table
+    ReadLock readRecords() const;
+    static bool ticketsReady(const ProjectData& data, const TicketNeeds& needs);
+    static void prepareTickets(ProjectData& data, const TicketNeeds& needs);
+    static bool recordsCompacted(const ProjectData& data);
+    // Drops the tombstones erases leave behind, in one pass per table
+    static void compactRecords(ProjectData& data);
+
+    mutable std::shared_mutex mutex_;
+    // Held by a writer while it waits for mutex_, so new readers queue
+    // behind it; std::shared_mutex alone may let a stream of readers
+    // starve writers
+    mutable std::mutex write_gate_;
     bool createTables();
     bool isSQLiteAvailable() const;
-    std::string getProjectFilePath(const std::string& project_name);
+    std::string getProjectFilePath(const std::string& project_name) const;
+    std::string getProjectFilePath(const std::string& project_name, SnapshotFormat format) const;
+    std::string getJournalFilePath(const std::string& project_name) const;
+    std::string getArchiveDirectory(const std::string& project_name);
     void clearInMemoryData();
     void loadInMemoryData();
 
@@ -66,18 +251,56 @@ private:
     std::string current_project_;
     bool use_sqlite_ = false;
 
-    // In-memory storage organized by project
-    struct ProjectData {
-        std::vector<User> users;
-        std::vector<Ticket> tickets;
-        std::vector<Sprint> sprints;
-        std::vector<Activity> activities;
-        int next_user_id = 1;
-        int next_ticket_id = 1;
-        int next_sprint_id = 1;
-        int next_activity_id = 1;
-    };
+    // Encodes a save under the caller's write lock. Wait on the result only
+    // after that lock is released; it is invalid if nothing was queued.
+    std::future<bool> queueSave(const std::string& project_name);
+    void dropUnsavedProject(const std::string& project_name);
+    uint64_t rotateJournal(const std::string& project_name);
+
+    // `archived` entries older than those in `data` are written ahead of
+    // them; saves pass none, as the archive keeps its own files
+    static std::string encodeJsonSnapshot(const ProjectData& data, const std::vector<Activity>& archived = {});
+    static bool saveJsonSnapshot(const std::string& file_path, const ProjectData& data,
+                                 const std::vector<Activity>& archived = {});
+    bool loadArchivedActivities(const std::string& project_name, std::vector<Activity>& out);
+    static bool loadJsonSnapshot(const std::string& file_path, ProjectData& data);
+    static void rebuildIndexes(ProjectData& data);
+    static void materializeTickets(ProjectData& data);
+    static void applyJournalRecord(ProjectData& data, const json& record);
+    static void markDirty(ProjectData& data, const std::string& entity, int id);
+    static void indexTicket(ProjectData& data, const Ticket& ticket);
+    static void unindexTicket(ProjectData& data, const Ticket& ticket);
+    static void storeTicket(ProjectData& data, const Ticket& ticket);
+    static void removeTicket(ProjectData& data, int id);
+    static void buildTables(ProjectData& data);
+    static void syncTables(ProjectData& data, const std::string& entity, int id);
 
     std::map<std::string, ProjectData> projects_;
     ProjectData* current_data_ = nullptr;
+    SnapshotFormat default_format_ = SnapshotFormat::Binary;
+    bool lazy_loading_ = true;
+    size_t activity_capacity_ = ActivityStore::kDefaultCapacity;
+
+    // Journal of the current project; reopened by switchProject()
+    ProjectJournal journal_;
+    size_t journal_compaction_threshold_ = 1000;
+
+    // Snapshot writer; its jobs own copies of everything they write, so
+    // they never touch ProjectData from the background thread
+    SaveWorker save_worker_;
+
+    void journalPut(const std::string& entity, const json& record, ChangeKind kind);
+    void journalErase(const std::string& entity, int id);
+    void recordActivity(const Activity& activity);
+
+    void publishChange(ChangeEntity entity, ChangeKind kind, int id);
+    void publishReload();
+    void deliverChanges(const std::vector<ChangeEvent>& events) const;
+    std::array<uint64_t, kChangeEntityCount> versions_{};
+    // Raised by the write in progress; WriteLock hands them out
+    mutable std::vector<ChangeEvent> pending_changes_;
+    // Separate from mutex_ so listeners can come and go while others read
+    mutable std::mutex listeners_mutex_;
+    std::map<int, ChangeListener> listeners_;
+    int next_subscription_ = 1;
 };
\ No newline at end of file
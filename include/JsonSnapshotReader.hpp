@@ -0,0 +1,15 @@
+//JsonSnapshotReader.hpp
+#pragma once
+#include "ProjectData.hpp"
+#include <istream>
+#include <string>
+
+// Streaming reader for JSON project snapshots. Records are built straight
+// from the parser's SAX events, so no intermediate DOM is held and peak
+// memory stays close to the size of the loaded records themselves.
+class JsonSnapshotReader
+{
+public:
+    // On failure data is left partially filled and error says why
+    static bool read(std::istream& in, ProjectData& data, std::string& error);
+};
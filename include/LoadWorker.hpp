@@ -0,0 +1,33 @@
+//LoadWorker.hpp
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Single background thread for slow reads the UI must not wait on, such
+// as decoding a project from disk. Jobs run in the order posted; each one
+// hands its result back to the UI thread itself.
+class LoadWorker
+{
+public:
+    LoadWorker();
+    // Finishes the job in progress; jobs not yet started are dropped
+    ~LoadWorker();
+    LoadWorker(const LoadWorker&) = delete;
+    LoadWorker& operator=(const LoadWorker&) = delete;
+
+    void post(std::function<void()> job);
+
+private:
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> jobs_;
+    bool stopping_ = false;
+
+    // Last, so everything run() touches exists before the thread starts
+    std::thread thread_;
+};
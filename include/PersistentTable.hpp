@@ -0,0 +1,284 @@
+//PersistentTable.hpp
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Records keyed by positive id, kept in fixed-size chunks by id range that
+// copies of the table share. Copying a table is O(1). A change edits in
+// place only the chunks this table made since it was last copied; any
+// other chunk, and the chunk directory, are copied first, so a copy never
+// sees a later change.
+//
+// Copies may be read on other threads. Changing a table, and copying it
+// while it changes, need the caller's lock: copying marks the source, and
+// that mark must reach the thread that changes it next.
+template <typename Record>
+class PersistentTable
+{
+public:
+    static constexpr size_t kChunkSize = 64;
+
+    PersistentTable() = default;
+    PersistentTable(const PersistentTable& other);
+    PersistentTable(PersistentTable&& other) noexcept;
+    PersistentTable& operator=(const PersistentTable& other);
+    PersistentTable& operator=(PersistentTable&& other) noexcept;
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const Record* find(int id) const;
+    // Calls visit(record) in id order until it returns false
+    template <typename Visit>
+    void forEach(Visit&& visit) const;
+
+    void put(const Record& record);
+    void erase(int id);
+    // Drops every record with an id below `id`
+    void eraseBelow(int id);
+    void clear();
+
+private:
+    struct Chunk
+    {
+        std::array<std::optional<Record>, kChunkSize> records;
+        size_t count = 0;
+        // Table that may change it in place
+        uint64_t owner = 0;
+    };
+    using Directory = std::vector<std::shared_ptr<Chunk>>;
+
+    static uint64_t newOwner()
+    {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Directory& writableDirectory();
+    Chunk* writableChunk(size_t index, bool create);
+
+    std::shared_ptr<Directory> directory_;
+    size_t size_ = 0;
+    // Changes to the chunks made under this id are not visible to any copy
+    uint64_t owner_ = newOwner();
+    uint64_t directory_owner_ = 0;
+    // Set by copying; the next change then takes a new owner id
+    mutable std::atomic<bool> copied_{false};
+};
+
+template <typename Record>
+PersistentTable<Record>::PersistentTable(const PersistentTable& other)
+    : directory_(other.directory_),
+      size_(other.size_)
+{
+    other.copied_.store(true, std::memory_order_relaxed);
+}
+
+template <typename Record>
+PersistentTable<Record>::PersistentTable(PersistentTable&& other) noexcept
+    : directory_(std::move(other.directory_)),
+      size_(other.size_),
+      owner_(other.owner_),
+      directory_owner_(other.directory_owner_),
+      copied_(other.copied_.load(std::memory_order_relaxed))
+{
+    other.size_ = 0;
+    other.owner_ = newOwner();
+}
+
+template <typename Record>
+PersistentTable<Record>& PersistentTable<Record>::operator=(const PersistentTable& other)
+{
+    if (this != &other)
+    {
+        directory_ = other.directory_;
+        size_ = other.size_;
+        owner_ = newOwner();
+        directory_owner_ = 0;
+        copied_.store(false, std::memory_order_relaxed);
+        other.copied_.store(true, std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+template <typename Record>
+PersistentTable<Record>& PersistentTable<Record>::operator=(PersistentTable&& other) noexcept
+{
+    directory_ = std::move(other.directory_);
+    size_ = other.size_;
+    owner_ = other.owner_;
+    directory_owner_ = other.directory_owner_;
+    copied_.store(other.copied_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    other.size_ = 0;
+    other.owner_ = newOwner();
+    return *this;
+}
+
+template <typename Record>
+typename PersistentTable<Record>::Directory& PersistentTable<Record>::writableDirectory()
+{
+    // Everything made so far may now be shared with the copy
+    if (copied_.exchange(false, std::memory_order_relaxed))
+    {
+        owner_ = newOwner();
+    }
+    if (!directory_)
+    {
+        directory_ = std::make_shared<Directory>();
+        directory_owner_ = owner_;
+    }
+    else if (directory_owner_ != owner_)
+    {
+        directory_ = std::make_shared<Directory>(*directory_);
+        directory_owner_ = owner_;
+    }
+    return *directory_;
+}
+
+template <typename Record>
+typename PersistentTable<Record>::Chunk* PersistentTable<Record>::writableChunk(size_t index, bool create)
+{
+    if (!create && (!directory_ || index >= directory_->size() || !(*directory_)[index]))
+    {
+        return nullptr;
+    }
+
+    Directory& directory = writableDirectory();
+    if (index >= directory.size())
+    {
+        directory.resize(index + 1);
+    }
+    std::shared_ptr<Chunk>& chunk = directory[index];
+    if (!chunk)
+    {
+        chunk = std::make_shared<Chunk>();
+    }
+    else if (chunk->owner != owner_)
+    {
+        chunk = std::make_shared<Chunk>(*chunk);
+    }
+    chunk->owner = owner_;
+    return chunk.get();
+}
+
+template <typename Record>
+const Record* PersistentTable<Record>::find(int id) const
+{
+    if (id <= 0 || !directory_)
+    {
+        return nullptr;
+    }
+    const size_t index = static_cast<size_t>(id) / kChunkSize;
+    if (index >= directory_->size() || !(*directory_)[index])
+    {
+        return nullptr;
+    }
+    const std::optional<Record>& record = (*directory_)[index]->records[static_cast<size_t>(id) % kChunkSize];
+    return record ? &*record : nullptr;
+}
+
+template <typename Record>
+template <typename Visit>
+void PersistentTable<Record>::forEach(Visit&& visit) const
+{
+    if (!directory_)
+    {
+        return;
+    }
+    for (const auto& chunk : *directory_)
+    {
+        if (!chunk)
+        {
+            continue;
+        }
+        for (const auto& record : chunk->records)
+        {
+            if (record && !visit(*record))
+            {
+                return;
+            }
+        }
+    }
+}
+
+template <typename Record>
+void PersistentTable<Record>::put(const Record& record)
+{
+    if (record.id <= 0)
+    {
+        return;
+    }
+    Chunk* chunk = writableChunk(static_cast<size_t>(record.id) / kChunkSize, true);
+    std::optional<Record>& slot = chunk->records[static_cast<size_t>(record.id) % kChunkSize];
+    if (!slot)
+    {
+        ++chunk->count;
+        ++size_;
+    }
+    slot = record;
+}
+
+template <typename Record>
+void PersistentTable<Record>::erase(int id)
+{
+    if (!find(id))
+    {
+        return;
+    }
+    const size_t index = static_cast<size_t>(id) / kChunkSize;
+    Chunk* chunk = writableChunk(index, false);
+    chunk->records[static_cast<size_t>(id) % kChunkSize].reset();
+    --size_;
+    // Empty chunks go, so ranges that have been cleared cost nothing
+    if (--chunk->count == 0)
+    {
+        (*directory_)[index].reset();
+    }
+}
+
+template <typename Record>
+void PersistentTable<Record>::eraseBelow(int id)
+{
+    if (!directory_ || id <= 0)
+    {
+        return;
+    }
+    const size_t partial_index = static_cast<size_t>(id) / kChunkSize;
+    const size_t whole = std::min(partial_index, directory_->size());
+    size_t dropped = 0;
+    for (size_t index = 0; index < whole; ++index)
+    {
+        if ((*directory_)[index])
+        {
+            dropped += (*directory_)[index]->count;
+        }
+    }
+    if (dropped > 0)
+    {
+        Directory& directory = writableDirectory();
+        for (size_t index = 0; index < whole; ++index)
+        {
+            directory[index].reset();
+        }
+        size_ -= dropped;
+    }
+    if (partial_index < directory_->size() && (*directory_)[partial_index])
+    {
+        for (int partial = static_cast<int>(partial_index * kChunkSize); partial < id; ++partial)
+        {
+            erase(partial);
+        }
+    }
+}
+
+template <typename Record>
+void PersistentTable<Record>::clear()
+{
+    directory_.reset();
+    size_ = 0;
+    directory_owner_ = 0;
+}
@@ -0,0 +1,108 @@
+//ProjectData.hpp
+#pragma once
+#include "models.hpp"
+#include "ActivityStore.hpp"
+#include "ProjectSnapshot.hpp"
+#include "TicketColumns.hpp"
+#include "TicketOrderIndex.hpp"
+#include "TicketSearchIndex.hpp"
+#include "TrigramIndex.hpp"
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class LazyTicketTable;
+
+// On-disk representation used when a project is saved
+enum class SnapshotFormat { Json, Binary, Segmented };
+
+// Parts of a project changed since its last save. Only the segmented
+// format uses this; the single-file formats always rewrite everything.
+struct DirtySegments
+{
+    static constexpr int kTicketsPerSegment = 1024;
+    static constexpr int kActivitiesPerSegment = 4096;
+
+    static int ticketSegment(int id) { return id / kTicketsPerSegment; }
+    static int activitySegment(int id) { return id / kActivitiesPerSegment; }
+
+    // Set until the project has been written in full once
+    bool all = true;
+    // Users, sprints and the id counters
+    bool meta = false;
+    std::set<int> tickets;
+    std::set<int> activities;
+
+    void markMeta() { meta = true; }
+    void markTicket(int id) { meta = true; tickets.insert(ticketSegment(id)); }
+    void markActivity(int id) { meta = true; activities.insert(activitySegment(id)); }
+    void markActivities(int first_id, int last_id)
+    {
+        meta = true;
+        for (int segment = activitySegment(first_id); segment <= activitySegment(last_id); ++segment)
+        {
+            activities.insert(segment);
+        }
+    }
+    bool empty() const { return !all && !meta && tickets.empty() && activities.empty(); }
+};
+
+// In-memory storage for one project
+struct ProjectData {
+    std::vector<User> users;
+    std::vector<Ticket> tickets;
+    TicketColumns ticket_columns;
+    std::vector<Sprint> sprints;
+    ActivityStore activities;
+    int next_user_id = 1;
+    int next_ticket_id = 1;
+    int next_sprint_id = 1;
+    int next_activity_id = 1;
+    SnapshotFormat format = SnapshotFormat::Json;
+    DirtySegments dirty;
+
+    // Raised by a background segment write that failed; the next save then
+    // rewrites everything, since its dirty set was already handed off
+    std::shared_ptr<std::atomic<bool>> save_failed = std::make_shared<std::atomic<bool>>(false);
+
+    // Highest activity id the background saver has written to the archive;
+    // sealed batches up to it can leave memory and the snapshot
+    std::shared_ptr<std::atomic<int>> archived_through = std::make_shared<std::atomic<int>>(0);
+
+    // Set while tickets still live only in a mapped binary snapshot; the
+    // vector and ticket indexes above are empty until it is materialized
+    std::shared_ptr<LazyTicketTable> lazy_tickets;
+
+    // Primary-key indexes: record id -> slot in the vectors above
+    std::unordered_map<int, size_t> user_slots;
+    std::unordered_map<int, size_t> ticket_slots;
+    std::unordered_map<int, size_t> sprint_slots;
+
+    // Erased records still holding a slot as tombstones (id 0), so an erase
+    // never shifts the vectors; reads that walk a table compact them first
+    size_t erased_users = 0;
+    size_t erased_tickets = 0;
+    size_t erased_sprints = 0;
+
+    // Secondary ticket indexes: key -> ids of matching tickets
+    std::unordered_map<int, std::unordered_set<int>> tickets_by_sprint;
+    std::unordered_map<int, std::unordered_set<int>> tickets_by_assignee;
+    std::unordered_map<TicketStatus, std::unordered_set<int>> tickets_by_status;
+
+    // Full-text and trigram indexes over ticket text, each built by the
+    // first search that needs it
+    TicketSearchIndex search_index;
+    TrigramIndex trigram_index;
+
+    // Tickets sorted by each query order in use, built by the first query
+    // that sorts by it
+    TicketOrderIndex order_index;
+
+    // Shared-chunk copy of every record that in-memory snapshots are cut
+    // from, built by the first one taken
+    ProjectTables tables;
+};
@@ -0,0 +1,59 @@
+//ProjectJournal.hpp
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../external/nlohmann/json/single_include/nlohmann/json.hpp"
+
+// Append-only redo log for one project. Every mutation DatabaseManager makes
+// is written as a single JSON line and synced to disk before append()
+// returns, so an edit costs one record of I/O plus a sync, and neither a
+// crash nor a power loss drops a record append() reported written. The
+// snapshot written by saveProject() absorbs the log, after which it is
+// rotated away.
+class ProjectJournal
+{
+public:
+    ProjectJournal() = default;
+    ~ProjectJournal() { close(); }
+    ProjectJournal(const ProjectJournal&) = delete;
+    ProjectJournal& operator=(const ProjectJournal&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const;
+
+    bool append(const nlohmann::json& record);
+    size_t recordCount() const { return record_count_; }
+
+    // Moves the log aside to rotated_path and starts an empty one in its
+    // place. Used by background saves: the rotated log stays replayable
+    // until the snapshot that absorbs it is safely on disk.
+    bool rotate(const std::string& rotated_path);
+
+    // Rotated logs are named <path>.<generation>; listed oldest first
+    static std::string rotatedPath(const std::string& path, uint64_t generation);
+    static std::vector<std::pair<uint64_t, std::string>> rotatedLogs(const std::string& path);
+
+    // Feeds every intact record to apply(); a torn final line from a crash
+    // mid-append is ignored. Returns the number of records applied.
+    static size_t replay(const std::string& path,
+                         const std::function<void(const nlohmann::json&)>& apply);
+
+private:
+    // Opens path_ for appending, emptied first if `truncate`
+    bool openFile(bool truncate);
+    // Writes all of `bytes` and waits for them to reach the disk
+    bool writeSynced(const std::string& bytes);
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    std::string path_;
+    size_t record_count_ = 0;
+};
@@ -0,0 +1,75 @@
+//ProjectSnapshot.hpp
+#pragma once
+#include "models.hpp"
+#include "ChangeEvent.hpp"
+#include "PersistentTable.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct ProjectData;
+
+// Every record of a project in tables that copies share. A project keeps
+// one, built by the first snapshot taken of it and updated by every write
+// from then on; each snapshot holds a copy.
+struct ProjectTables
+{
+    PersistentTable<User> users;
+    PersistentTable<Ticket> tickets;
+    PersistentTable<Sprint> sprints;
+    PersistentTable<Activity> activities;
+    bool built = false;
+
+    void clear() { *this = ProjectTables{}; }
+};
+
+// Immutable, reference-counted version of a project's records, from
+// DatabaseManager::takeSnapshot(). Long reads (exports, reports, index
+// builds) use one to see a single consistent version without holding the
+// database lock. Taking one is O(1); later writes copy the chunks they
+// touch instead of changing the ones it holds. Safe to read from any
+// thread; copies are cheap and share everything.
+//
+// Not to be confused with the on-disk snapshots the project is saved to,
+// though copyTo() feeds their encoders.
+class ProjectSnapshot
+{
+public:
+    // Holds no project
+    ProjectSnapshot() = default;
+
+    bool valid() const { return state_ != nullptr; }
+    const std::string& projectName() const;
+    // DatabaseManager's version counter for `entity` when this was taken
+    uint64_t version(ChangeEntity entity) const;
+
+    // Records in id order
+    const PersistentTable<User>& users() const;
+    const PersistentTable<Ticket>& tickets() const;
+    const PersistentTable<Sprint>& sprints() const;
+    // The activities held in memory when this was taken
+    const PersistentTable<Activity>& activities() const;
+
+    // Fills `data` with these records and id counters; indexes are left
+    // for the caller to build if it needs them
+    void copyTo(ProjectData& data) const;
+
+private:
+    friend class DatabaseManager;
+
+    struct State
+    {
+        std::string project_name;
+        ProjectTables tables;
+        int next_user_id = 1;
+        int next_ticket_id = 1;
+        int next_sprint_id = 1;
+        int next_activity_id = 1;
+        std::array<uint64_t, kChangeEntityCount> versions{};
+    };
+
+    explicit ProjectSnapshot(std::shared_ptr<const State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<const State> state_;
+};
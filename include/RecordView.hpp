@@ -0,0 +1,29 @@
+//RecordView.hpp
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Read-only window onto one of DatabaseManager's record tables. A view never
+// copies records; it stays valid until the next mutation or project switch,
+// so callers fetch a fresh one after writing.
+template <typename Record>
+class RecordView
+{
+public:
+    using value_type = Record;
+    using const_iterator = const Record*;
+
+    RecordView() = default;
+    explicit RecordView(const std::vector<Record>& records)
+        : data_(records.data()), size_(records.size()) {}
+
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const Record& operator[](size_t index) const { return data_[index]; }
+
+private:
+    const Record* data_ = nullptr;
+    size_t size_ = 0;
+};
@@ -0,0 +1,56 @@
+//SaveWorker.hpp
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+// Save latency, measured from the moment a job starts writing until its
+// file is durable on disk
+struct SaveStats
+{
+    uint64_t saves = 0;
+    uint64_t failures = 0;
+    std::chrono::microseconds last_latency{ 0 };
+    std::chrono::microseconds max_latency{ 0 };
+    std::chrono::microseconds total_latency{ 0 };
+};
+
+// Single background thread that performs snapshot writes in the order they
+// were queued, so the thread that asked for a save never waits on the disk
+class SaveWorker
+{
+public:
+    SaveWorker();
+    ~SaveWorker();
+    SaveWorker(const SaveWorker&) = delete;
+    SaveWorker& operator=(const SaveWorker&) = delete;
+
+    // The job returns whether the write succeeded; the future carries that
+    // result for callers that do want to wait
+    std::future<bool> post(std::function<bool()> job);
+
+    SaveStats stats() const;
+
+private:
+    struct Job
+    {
+        std::function<bool()> write;
+        std::promise<bool> done;
+    };
+
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Job> jobs_;
+    bool stopping_ = false;
+    SaveStats stats_;
+
+    // Last, so everything run() touches exists before the thread starts
+    std::thread thread_;
+};
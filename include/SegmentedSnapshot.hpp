@@ -0,0 +1,34 @@
+//SegmentedSnapshot.hpp
+#pragma once
+#include "ProjectData.hpp"
+#include <string>
+#include <vector>
+
+// One file of a segmented snapshot; empty bytes mean the file is removed
+struct SnapshotSegment
+{
+    std::string name;
+    std::string bytes;
+};
+
+// Project snapshot split into independently replaceable files under
+// projects/<name>.rsd/:
+//
+//   meta.rsp              users, sprints and the next-id counters
+//   tickets-<k>.rsp       tickets with id / kTicketsPerSegment == k
+//   activities-<k>.rsp    activities with id / kActivitiesPerSegment == k
+//
+// Every file is an ordinary binary snapshot holding just its slice, so a
+// save re-encodes and rewrites only the segments named in DirtySegments.
+class SegmentedSnapshot
+{
+public:
+    static std::vector<SnapshotSegment> encode(const ProjectData& data, const DirtySegments& dirty);
+
+    // Writes each segment atomically. With replace_all, segment files not
+    // in the list are deleted, which a full rewrite needs.
+    static bool write(const std::string& directory, const std::vector<SnapshotSegment>& segments,
+                      bool replace_all);
+
+    static bool load(const std::string& directory, ProjectData& data);
+};
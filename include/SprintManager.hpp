@@ -1,6 +1,7 @@
 //SprintManager.hpp
 #pragma once
 #include "models.hpp"
+#include "SprintStats.hpp"
 #include <vector>
 
 class SprintManager
@@ -17,6 +18,8 @@ public:
     std::vector<Sprint> getSprintsByStatus(const std::string &status);
     bool startSprint(int sprint_id);
     bool completeSprint(int sprint_id);
+    // Points, status counts and per-assignee load over the ticket columns
+    SprintStats getSprintStats(int sprint_id);
 
 private:
     SprintManager() = default;
@@ -0,0 +1,41 @@
+//SprintStats.hpp
+#pragma once
+#include "models.hpp"
+#include "TicketColumns.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct AssigneeLoad
+{
+    int assignee_id = 0;
+    size_t tickets = 0;
+    // Story points not yet done
+    int64_t open_points = 0;
+};
+
+struct SprintStats
+{
+    int sprint_id = 0;
+    size_t tickets = 0;
+    int64_t total_points = 0;
+    int64_t completed_points = 0;
+    // Indexed by TicketStatus
+    std::array<size_t, kTicketStatusCount> status_counts{};
+    // Heaviest open load first
+    std::vector<AssigneeLoad> assignee_load;
+};
+
+// Aggregates over TicketColumns. compute() picks an AVX2 kernel when the
+// CPU has it and falls back to the portable loop otherwise. Both sum in 64
+// bits, so they give the same result for any story point values.
+class SprintStatsEngine
+{
+public:
+    static SprintStats compute(const TicketColumns& columns, int sprint_id);
+    static SprintStats computeScalar(const TicketColumns& columns, int sprint_id);
+
+    // "avx2" or "scalar", for diagnostics
+    static const char* kernelName();
+};
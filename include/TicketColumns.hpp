@@ -0,0 +1,44 @@
+//TicketColumns.hpp
+#pragma once
+#include "models.hpp"
+#include "RecordView.hpp"
+#include <cstddef>
+#include <vector>
+
+// Scalar ticket fields stored column by column, slot-aligned with
+// ProjectData::tickets. Aggregate scans (burndown, velocity, per-status
+// counts) read just the columns they need as contiguous arrays instead of
+// striding over whole Ticket rows and their strings. Title and description
+// are not mirrored; they stay in the row table.
+class TicketColumns
+{
+public:
+    size_t size() const { return ids_.size(); }
+    bool empty() const { return ids_.empty(); }
+
+    void clear();
+    void assign(const std::vector<Ticket>& tickets);
+    void push_back(const Ticket& ticket);
+    void set(size_t slot, const Ticket& ticket);
+
+    RecordView<int> ids() const { return RecordView<int>(ids_); }
+    RecordView<TicketStatus> statuses() const { return RecordView<TicketStatus>(statuses_); }
+    RecordView<TicketPriority> priorities() const { return RecordView<TicketPriority>(priorities_); }
+    RecordView<TicketType> types() const { return RecordView<TicketType>(types_); }
+    RecordView<int> sprintIds() const { return RecordView<int>(sprint_ids_); }
+    RecordView<int> assigneeIds() const { return RecordView<int>(assignee_ids_); }
+    RecordView<int> storyPoints() const { return RecordView<int>(story_points_); }
+    RecordView<time_t> createdAt() const { return RecordView<time_t>(created_at_); }
+    RecordView<time_t> updatedAt() const { return RecordView<time_t>(updated_at_); }
+
+private:
+    std::vector<int> ids_;
+    std::vector<TicketStatus> statuses_;
+    std::vector<TicketPriority> priorities_;
+    std::vector<TicketType> types_;
+    std::vector<int> sprint_ids_;
+    std::vector<int> assignee_ids_;
+    std::vector<int> story_points_;
+    std::vector<time_t> created_at_;
+    std::vector<time_t> updated_at_;
+};
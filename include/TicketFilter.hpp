@@ -0,0 +1,100 @@
+//TicketFilter.hpp
+#pragma once
+#include "models.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Live ticket filter for search-as-you-type. Matching (case-insensitive
+// substring of title or description) runs on its own thread over a
+// private copy of the ticket text, folded there from whatever a
+// TicketSource walks, so the caller's thread only posts resets,
+// keystrokes and ticket edits.
+//
+// Keystrokes are debounced: a query runs once typing has paused. A query
+// that contains an earlier one can only match a subset of its tickets, so
+// it re-checks that earlier result set instead of every ticket; recent
+// result sets are kept for this, which also makes backspacing cheap.
+class TicketFilter
+{
+public:
+    // Called on the filter thread with the query and the ids it matched
+    using ResultCallback = std::function<void(const std::string& query, std::vector<int> ids)>;
+    // Hands each ticket to `visit` until it returns false; called on the
+    // filter thread
+    using TicketSource = std::function<void(const std::function<bool(const Ticket&)>& visit)>;
+
+    TicketFilter(std::chrono::milliseconds debounce, ResultCallback on_result);
+    ~TicketFilter();
+
+    TicketFilter(const TicketFilter&) = delete;
+    TicketFilter& operator=(const TicketFilter&) = delete;
+
+    // Replaces the text being searched with the tickets `source` walks
+    void reset(TicketSource source);
+    // Single-ticket edits to the text; the current query is re-run
+    void update(const Ticket& ticket);
+    void erase(int id);
+    void setQuery(const std::string& query);
+
+private:
+    struct Corpus
+    {
+        std::vector<int> ids;
+        // Folded "title\ndescription" per ticket
+        std::vector<std::string> text;
+        // Id -> position in the vectors above
+        std::unordered_map<int, size_t> positions;
+    };
+
+    struct Edit
+    {
+        int id;
+        bool erased;
+        // Not yet folded
+        std::string text;
+    };
+
+    struct CachedResult
+    {
+        std::string query;
+        // Positions in the corpus, ascending
+        std::vector<size_t> matches;
+    };
+
+    static constexpr size_t kCachedResults = 16;
+
+    static std::string ticketText(const Ticket& ticket);
+    static std::unique_ptr<Corpus> buildCorpus(const TicketSource& source);
+    static void applyEdit(Corpus& corpus, Edit& edit);
+
+    void queueEdit(Edit edit);
+    void run();
+    std::vector<size_t> match(const std::string& query);
+
+    const std::chrono::milliseconds debounce_;
+    const ResultCallback on_result_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    // Handed to the filter thread, which builds a corpus from it at once
+    TicketSource incoming_;
+    bool has_incoming_ = false;
+    std::vector<Edit> edits_;
+    std::string pending_query_;
+    bool has_pending_ = false;
+    std::chrono::steady_clock::time_point due_;
+    bool stop_ = false;
+
+    // Filter thread only
+    std::unique_ptr<Corpus> corpus_;
+    std::vector<CachedResult> cache_;
+
+    std::thread thread_;
+};
@@ -1,6 +1,7 @@
 //TicketManager.hpp
 #pragma once
 #include "models.hpp"
+#include "TicketQuery.hpp"
 #include <vector>
 
 class TicketManager
@@ -11,9 +12,16 @@ public:
 	bool createTicket(const Ticket &ticket);
 	bool updateTicket(const Ticket &ticket);
 	bool deleteTicket(int id);
+	// See TicketQuery; the getTicketsBy* helpers are single-predicate queries
+	std::vector<Ticket> queryTickets(const TicketQuery &query);
+	TicketPage getTicketPage(const TicketQuery &query, size_t page_size);
+	// Highest priority first, most recently updated within a priority
+	std::vector<Ticket> getTopTickets(size_t count);
 	std::vector<Ticket> getTicketsBySprint(int sprint_id);
 	std::vector<Ticket> searchTickets(const std::string &query);
-	std::vector<Ticket> getTicketsByStatus(const std::string &status);
+	std::vector<Ticket> searchTicketsSubstring(const std::string &fragment);
+	std::vector<Ticket> searchTicketsFuzzy(const std::string &fragment, int max_edits);
+	std::vector<Ticket> getTicketsByStatus(TicketStatus status);
 	std::vector<Ticket> getTicketsByAssignee(int assignee_id);
 
 private:
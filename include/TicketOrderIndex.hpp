@@ -0,0 +1,32 @@
+//TicketOrderIndex.hpp
+#pragma once
+#include "models.hpp"
+#include "TicketQuery.hpp"
+#include <array>
+#include <set>
+#include <vector>
+
+// Tickets kept sorted in each TicketQuery order that has been asked for.
+// An ordered query walks the set from its cursor and stops once the page
+// is full, instead of sorting every match. Each order is built by the
+// first query that sorts by it and maintained from then on.
+class TicketOrderIndex
+{
+public:
+    using Entries = std::set<TicketSortKey>;
+
+    bool built(TicketQuery::Order order) const { return built_[static_cast<size_t>(order)]; }
+    void build(TicketQuery::Order order, const std::vector<Ticket>& tickets);
+    void clear();
+
+    // Update every order built so far
+    void add(const Ticket& ticket);
+    void remove(const Ticket& ticket);
+
+    // Null until the order is built, and always for Order::None
+    const Entries* entries(TicketQuery::Order order) const;
+
+private:
+    std::array<Entries, TicketQuery::kOrderCount> orders_;
+    std::array<bool, TicketQuery::kOrderCount> built_{};
+};
@@ -0,0 +1,110 @@
+//TicketQuery.hpp
+#pragma once
+#include "models.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+
+struct ProjectData;
+
+// A ticket's position in a query's order: the order's key, a second key
+// (updated_at, for priority order), then id. Also used as a page cursor.
+struct TicketSortKey
+{
+    long long primary = 0;
+    long long secondary = 0;
+    int id = 0;
+
+    bool operator<(const TicketSortKey& other) const
+    {
+        return std::tie(primary, secondary, id) < std::tie(other.primary, other.secondary, other.id);
+    }
+};
+
+// One page of a paginated query
+struct TicketPage
+{
+    std::vector<Ticket> tickets;
+    // Pass to TicketQuery::after() for the next page; meaningful only
+    // when has_more is set
+    TicketSortKey next;
+    bool has_more = false;
+};
+
+// Conjunction of ticket predicates with an optional order and limit,
+// built up by chaining:
+//
+//     TicketQuery().status(TicketStatus::Todo).assignee(3).orderBy(TicketQuery::Order::UpdatedAt, true).limit(20)
+//
+// run() picks the most selective index among the predicates that have
+// one (status, assignee, sprint, and the trigram index for text), walks
+// only that posting list, and tests the rest against the ticket columns,
+// touching a ticket row just for the text check and for each match it
+// hands out. Unordered queries stream and stop as soon as the limit is
+// reached. Ordered ones walk a TicketOrderIndex when no posting list
+// drives the walk, so a page costs about its own size; otherwise they keep
+// the best `limit` matching slots in a heap.
+class TicketQuery
+{
+public:
+    // Priority order breaks ties on updated_at
+    enum class Order : uint8_t { None, Id, CreatedAt, UpdatedAt, Priority, StoryPoints };
+    static constexpr size_t kOrderCount = 6;
+
+    // Called once per match, in order; return false to stop early
+    using Visitor = std::function<bool(const Ticket&)>;
+
+    // status() may be chained to accept several statuses
+    TicketQuery& status(TicketStatus status);
+    TicketQuery& assignee(int assignee_id);
+    TicketQuery& sprint(int sprint_id);
+    // Inclusive on both ends
+    TicketQuery& storyPoints(int min_points, int max_points);
+    // Case-insensitive substring of title or description
+    TicketQuery& text(const std::string& fragment);
+    // Strictly after `time`
+    TicketQuery& updatedAfter(time_t time);
+    // Ties are broken by id, in the same direction
+    TicketQuery& orderBy(Order order, bool descending = false);
+    TicketQuery& limit(size_t count);
+    // Only tickets after `cursor` in this query's order
+    TicketQuery& after(const TicketSortKey& cursor);
+
+    bool hasText() const { return !text_.empty(); }
+    Order order() const { return order_; }
+
+    static TicketSortKey sortKey(Order order, const Ticket& ticket);
+
+    // Uses the trigram and order indexes only when they have been built;
+    // the caller builds them, as the search functions do
+    void run(const ProjectData& data, const Visitor& visit) const;
+
+private:
+    static constexpr int kAnyId = std::numeric_limits<int>::min();
+    // Below this many candidates, checking text directly beats merging
+    // trigram posting lists
+    static constexpr size_t kVerifyDirectly = 256;
+    // A posting list drives the walk only when it holds under 1/kScanRatio
+    // of the tickets; past that, the slot lookups cost more than a scan
+    static constexpr size_t kScanRatio = 32;
+
+    uint8_t status_mask_ = 0;
+    int assignee_id_ = kAnyId;
+    int sprint_id_ = kAnyId;
+    int min_points_ = std::numeric_limits<int>::min();
+    int max_points_ = std::numeric_limits<int>::max();
+    // Folded
+    std::string text_;
+    bool has_updated_after_ = false;
+    time_t updated_after_ = 0;
+    Order order_ = Order::None;
+    bool descending_ = false;
+    size_t limit_ = SIZE_MAX;
+    bool has_cursor_ = false;
+    TicketSortKey cursor_;
+};
@@ -0,0 +1,58 @@
+//TicketSearchIndex.hpp
+#pragma once
+#include "models.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Inverted index over ticket titles and descriptions. Text is split into
+// runs of letters and digits and ASCII-lowercased; each term maps to the
+// ids of the tickets containing it, kept sorted so multi-term queries are
+// list intersections.
+//
+// Query syntax: whitespace-separated terms, all of which must match. A
+// term ending in '*' matches every indexed term it prefixes.
+class TicketSearchIndex
+{
+public:
+    static void tokenize(const std::string& text, std::vector<std::string>& terms);
+
+    // The index is built on the first search and maintained from then on;
+    // until then add() and remove() are no-ops
+    bool built() const { return built_; }
+    void build(const std::vector<Ticket>& tickets);
+    void clear();
+
+    void add(const Ticket& ticket);
+    void remove(const Ticket& ticket);
+
+    // Ids of tickets matching every term. Tickets matching all terms in
+    // the title come first, otherwise ascending id order.
+    std::vector<int> search(const std::string& query, size_t limit = SIZE_MAX) const;
+
+    size_t termCount() const { return postings_.size(); }
+
+private:
+    // (ticket id << 1) | 1 when the term occurs in the title
+    using Posting = uint32_t;
+    using PostingList = std::vector<Posting>;
+
+    static int postingId(Posting posting) { return static_cast<int>(posting >> 1); }
+    static bool inTitle(Posting posting) { return (posting & 1) != 0; }
+
+    // Distinct terms of a ticket, each flagged when it occurs in the title
+    using TicketTerms = std::vector<std::pair<std::string, bool>>;
+    static void collectTerms(const Ticket& ticket, TicketTerms& terms);
+    PostingList& listFor(const std::string& term);
+    void dropList(const std::string& term);
+    PostingList prefixPostings(const std::string& prefix) const;
+
+    std::unordered_map<std::string, PostingList> postings_;
+    // The same terms in order, for prefix queries
+    std::set<std::string> terms_;
+    bool built_ = false;
+};
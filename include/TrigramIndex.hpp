@@ -0,0 +1,75 @@
+//TrigramIndex.hpp
+#pragma once
+#include "models.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Index of the three-byte sequences in ticket titles and descriptions,
+// ASCII case-folded. It narrows substring and fuzzy searches to a set of
+// candidate tickets, which the caller then verifies against the text with
+// contains() or a FuzzyMatcher. Fragments too short to narrow anything
+// report so, and the caller falls back to checking every ticket.
+class TrigramIndex
+{
+public:
+    // Built by the first substring search and maintained from then on;
+    // until then add() and remove() are no-ops
+    bool built() const { return built_; }
+    void build(const std::vector<Ticket>& tickets);
+    void clear();
+
+    void add(const Ticket& ticket);
+    void remove(const Ticket& ticket);
+
+    // Ids, ascending, of tickets that may contain `fragment`. Returns
+    // false when the fragment is shorter than a trigram.
+    bool substringCandidates(const std::string& fragment, std::vector<int>& ids) const;
+    // Upper bound on the candidates above, from the shortest posting list
+    // alone; SIZE_MAX when the fragment is shorter than a trigram
+    size_t substringCandidateBound(const std::string& fragment) const;
+
+    // Ids of tickets that may contain a string within `max_edits` edits of
+    // `fragment`: each edit destroys at most three of its trigrams, so a
+    // match shares all but 3 * max_edits of them. Returns false when that
+    // bound leaves nothing to filter on.
+    bool fuzzyCandidates(const std::string& fragment, int max_edits, std::vector<int>& ids) const;
+
+    static std::string fold(const std::string& text);
+    // `folded_fragment` must already be folded
+    static bool contains(const std::string& text, const std::string& folded_fragment);
+
+private:
+    using PostingList = std::vector<int>;
+
+    static void collectTrigrams(const Ticket& ticket, std::vector<uint32_t>& trigrams);
+    static void fragmentTrigrams(const std::string& fragment, std::vector<uint32_t>& trigrams);
+
+    std::unordered_map<uint32_t, PostingList> postings_;
+    bool built_ = false;
+};
+
+// Approximate substring matcher for one fragment, prepared once per
+// search. Fragments of up to 64 bytes use Myers' bit-parallel algorithm,
+// one machine word per text byte; longer ones fall back to the plain
+// dynamic program.
+class FuzzyMatcher
+{
+public:
+    FuzzyMatcher(const std::string& fragment, int max_edits);
+
+    // Fewest edits turning the fragment into some substring of `text`, or
+    // max_edits + 1 when every substring needs more
+    int distance(const std::string& text) const;
+
+private:
+    int dynamicDistance(const std::string& text) const;
+
+    std::string fragment_;
+    int max_edits_;
+    // Bit i set where fragment byte i equals the index byte
+    std::array<uint64_t, 256> peq_{};
+};
@@ -7,14 +7,20 @@
 #include "DatabaseManager.hpp"
 #include "TicketManager.hpp"
 #include "SprintManager.hpp"
+#include "TicketFilter.hpp"
+#include "LoadWorker.hpp"
 #include <memory>
 #include <string>
 #include <vector>
 #include <chrono>
+#include <cstdint>
+#include <thread>
+#include <tuple>
 
 class UIManager {
 public:
     UIManager();
+    ~UIManager();
     void run();
 
 private:
@@ -25,12 +31,83 @@ private:
     enum class FocusPane { SPRINTS, TICKETS, ACTIVITY };
     FocusPane current_focus_ = FocusPane::SPRINTS;
 
-    int selected_sprint_ = 0;
-    int selected_ticket_ = 0;
-    std::vector<Sprint> sprints_;
+    // Scroll state of a list pane that builds elements only for the rows
+    // in view. `selected` indexes the whole list; `first` is the top row
+    // drawn and `rows` how many fit at the current terminal height.
+    struct ListWindow {
+        size_t selected = 0;
+        size_t first = 0;
+        size_t rows = 1;
+
+        // Both keep the selection in range and in view; they return true
+        // when the visible range moved
+        bool fit(size_t capacity, size_t count);
+        bool move(long delta, size_t count);
+    };
+
+    // Status bar, two separators, the activity pane and a list pane's
+    // header and footer
+    static constexpr int kChromeLines = 13;
+    // Extra lines drawn under the selected sprint and ticket
+    static constexpr int kSprintDetailLines = 5;
+    static constexpr int kTicketDetailLines = 2;
+
+    ListWindow sprint_window_;
+    ListWindow ticket_window_;
+
+    // A pane's last Element and the state it was built from. FTXUI redraws
+    // on every event; a pane whose state is unchanged reuses its Element
+    // instead of formatting every row again.
+    template <typename Key>
+    struct PaneMemo {
+        Key key{};
+        ftxui::Element element;
+        size_t rebuilds = 0;
+
+        template <typename Build>
+        ftxui::Element get(const Key& next, Build&& build) {
+            if (!element || next != key) {
+                key = next;
+                element = build();
+                ++rebuilds;
+            }
+            return element;
+        }
+    };
+    // Bumped by loadTicketRows(); the other panes key on DatabaseManager's
+    // version counters
+    uint64_t ticket_rows_version_ = 0;
+    // Data version, then the window (selected, first, rows) and focus
+    using ListPaneKey = std::tuple<uint64_t, size_t, size_t, size_t, bool>;
+    PaneMemo<ListPaneKey> sprint_pane_;
+    // As above, plus the search header
+    PaneMemo<std::tuple<ListPaneKey, std::string>> ticket_pane_;
+    PaneMemo<uint64_t> activity_pane_;
+
+    // Set by RETRO_SCRUM_DEBUG in the environment: the status bar shows
+    // how long the last frame took to build and how many panes it rebuilt
+    bool debug_frames_ = false;
+    std::chrono::steady_clock::duration last_frame_time_{};
+    size_t last_frame_rebuilds_ = 0;
+    // Views into DatabaseManager; re-fetched by loadData() after every write
+    RecordView<Sprint> sprints_;
+    RecordView<User> users_;
+
+    // Only the rows in the ticket window are fetched, so a lazily mapped
+    // project is never decoded in full just to paint a frame
     std::vector<Ticket> tickets_;
-    std::vector<Activity> activities_;
-    std::vector<User> users_;
+    size_t ticket_count_ = 0;
+    ActivityView activities_;
+
+    // Search-as-you-type: '/' starts typing, Enter keeps the filter, Esc
+    // clears it. Matching runs on ticket_filter_'s thread; results come
+    // back through screen_.Post().
+    static constexpr int kSearchDebounceMs = 120;
+    bool search_typing_ = false;
+    bool search_pending_ = false;
+    bool search_corpus_stale_ = true;
+    std::string search_query_;
+    std::vector<int> search_ids_;
 
     bool show_menu_ = false;
     bool quit_ = false;
@@ -115,4 +192,34 @@ private:
     std::string formatTime(time_t timestamp);
     std::string getFocusIndicator(FocusPane pane);
     void refreshData();
+    size_t paneRows(int detail_lines) const;
+    bool scrollFocusedPane(long delta);
+    const Ticket* selectedTicket() const;
+    
+    // Ticket search
+    bool handleSearchInput(ftxui::Event event);
+    void updateSearch();
+    void applySearchResults(const std::string& query, std::vector<int> ids);
+    static TicketFilter::TicketSource searchSource();
+    void loadTicketRows();
+
+    // Keeps the views above in step with DatabaseManager's change events.
+    // Those arrive on the thread that made the write, but only the thread
+    // that built this object, which also runs the screen, may touch the
+    // views; changes from any other thread are posted to it.
+    void applyChange(const ChangeEvent& change);
+    int change_subscription_ = 0;
+    const std::thread::id ui_thread_ = std::this_thread::get_id();
+
+    // Project switches that have to read from disk decode on load_worker_
+    // and are installed back on this thread; while one is in flight the
+    // status bar names the project and further switches are ignored
+    void loadProjectInBackground(const std::string& project_name);
+    std::string loading_project_;
+
+    // Both declared last so their threads stop before the screen they post
+    // to goes
+    LoadWorker load_worker_;
+
+    std::unique_ptr<TicketFilter> ticket_filter_;
 };
\ No newline at end of file
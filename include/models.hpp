@@ -3,8 +3,74 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <cstdint>
 #include <ctime>
 
+// Ticket classifications are stored as one-byte enums; the string forms
+// below are used only in JSON files and on screen
+enum class TicketStatus : uint8_t { Todo, InProgress, Review, Done };
+enum class TicketPriority : uint8_t { Low, Medium, High, Critical };
+enum class TicketType : uint8_t { Bug, Feature, Task, Story };
+constexpr size_t kTicketStatusCount = 4;
+
+inline const char* toString(TicketStatus status) {
+    switch (status) {
+    case TicketStatus::Todo:       return "todo";
+    case TicketStatus::InProgress: return "in_progress";
+    case TicketStatus::Review:     return "review";
+    case TicketStatus::Done:       return "done";
+    }
+    return "todo";
+}
+
+inline const char* toString(TicketPriority priority) {
+    switch (priority) {
+    case TicketPriority::Low:      return "low";
+    case TicketPriority::Medium:   return "medium";
+    case TicketPriority::High:     return "high";
+    case TicketPriority::Critical: return "critical";
+    }
+    return "medium";
+}
+
+inline const char* toString(TicketType type) {
+    switch (type) {
+    case TicketType::Bug:     return "bug";
+    case TicketType::Feature: return "feature";
+    case TicketType::Task:    return "task";
+    case TicketType::Story:   return "story";
+    }
+    return "task";
+}
+
+// Each returns false, leaving out untouched, for text it does not know
+inline bool parseTicketStatus(const std::string& text, TicketStatus& out) {
+    if (text == "todo") out = TicketStatus::Todo;
+    else if (text == "in_progress") out = TicketStatus::InProgress;
+    else if (text == "review") out = TicketStatus::Review;
+    else if (text == "done") out = TicketStatus::Done;
+    else return false;
+    return true;
+}
+
+inline bool parseTicketPriority(const std::string& text, TicketPriority& out) {
+    if (text == "low") out = TicketPriority::Low;
+    else if (text == "medium") out = TicketPriority::Medium;
+    else if (text == "high") out = TicketPriority::High;
+    else if (text == "critical") out = TicketPriority::Critical;
+    else return false;
+    return true;
+}
+
+inline bool parseTicketType(const std::string& text, TicketType& out) {
+    if (text == "bug") out = TicketType::Bug;
+    else if (text == "feature") out = TicketType::Feature;
+    else if (text == "task") out = TicketType::Task;
+    else if (text == "story") out = TicketType::Story;
+    else return false;
+    return true;
+}
+
 struct User {
     int id;
     std::string username;
@@ -21,16 +87,17 @@ struct Ticket {
     int id;
     std::string title;
     std::string description;
-    std::string status;      // "todo", "in_progress", "review", "done"
-    std::string priority;    // "low", "medium", "high", "critical"
-    std::string type;        // "bug", "feature", "task", "story"
+    TicketStatus status;
+    TicketPriority priority;
+    TicketType type;
     int assignee_id;
     int sprint_id;
     int story_points;
     time_t created_at;
     time_t updated_at;
     
-    Ticket() : id(0), assignee_id(0), sprint_id(0), story_points(0), 
+    Ticket() : id(0), status(TicketStatus::Todo), priority(TicketPriority::Medium), type(TicketType::Task),
+               assignee_id(0), sprint_id(0), story_points(0), 
                created_at(std::time(nullptr)), updated_at(std::time(nullptr)) {}
 };
 
@@ -0,0 +1,243 @@
+#include "ActivityStore.hpp"
+#include "BinarySnapshot.hpp"
+#include <algorithm>
+#include <filesystem>
+
+namespace
+{
+    const char kBatchPrefix[] = "activities-";
+    const char kBatchExtension[] = ".rsp";
+}
+
+void ActivityStore::setCapacity(size_t entries)
+{
+    entries = std::max<size_t>(entries, 1);
+
+    // Straighten the ring so the oldest entry is at the front, then spill
+    // whatever no longer fits
+    std::rotate(ring_.begin(), ring_.begin() + head_, ring_.end());
+    head_ = 0;
+    if (ring_.size() > entries)
+    {
+        size_t excess = ring_.size() - entries;
+        for (size_t i = 0; i < excess; ++i)
+        {
+            spill(std::move(ring_[i]));
+        }
+        ring_.erase(ring_.begin(), ring_.begin() + excess);
+    }
+    capacity_ = entries;
+}
+
+void ActivityStore::push_back(Activity activity)
+{
+    // A clock stepping backwards must not break the ordering the queries
+    // rely on
+    if (!empty() && activity.timestamp < back().timestamp)
+    {
+        activity.timestamp = back().timestamp;
+    }
+    if (activity.ticket_id != 0)
+    {
+        by_ticket_[activity.ticket_id].push_back(activity.id);
+    }
+
+    if (ring_.size() < capacity_)
+    {
+        ring_.push_back(std::move(activity));
+        return;
+    }
+
+    spill(std::move(ring_[head_]));
+    ring_[head_] = std::move(activity);
+    head_ = (head_ + 1) % ring_.size();
+}
+
+void ActivityStore::assign(std::vector<Activity>&& entries)
+{
+    clear();
+    for (auto& activity : entries)
+    {
+        push_back(std::move(activity));
+    }
+    entries.clear();
+}
+
+void ActivityStore::clear()
+{
+    ring_.clear();
+    head_ = 0;
+    open_batch_.clear();
+    sealed_.clear();
+    by_ticket_.clear();
+}
+
+size_t ActivityStore::size() const
+{
+    return sealed_.size() * kArchiveBatch + open_batch_.size() + ring_.size();
+}
+
+const Activity& ActivityStore::operator[](size_t index) const
+{
+    size_t sealed = sealed_.size() * kArchiveBatch;
+    if (index < sealed)
+    {
+        return sealed_[index / kArchiveBatch][index % kArchiveBatch];
+    }
+    index -= sealed;
+    if (index < open_batch_.size())
+    {
+        return open_batch_[index];
+    }
+    return ringAt(index - open_batch_.size());
+}
+
+ActivityView ActivityStore::recent(size_t limit) const
+{
+    size_t total = size();
+    return ActivityView(*this, total - std::min(limit, total), total);
+}
+
+ActivityView ActivityStore::between(time_t from, time_t to) const
+{
+    size_t first = partitionPoint([from](const Activity& a) { return a.timestamp < from; });
+    size_t last = partitionPoint([to](const Activity& a) { return a.timestamp < to; });
+    return ActivityView(*this, first, std::max(first, last));
+}
+
+std::vector<Activity> ActivityStore::forTicket(int ticket_id, size_t limit) const
+{
+    std::vector<Activity> result;
+    auto it = by_ticket_.find(ticket_id);
+    if (it == by_ticket_.end())
+    {
+        return result;
+    }
+
+    const std::deque<int>& ids = it->second;
+    result.reserve(std::min(limit, ids.size()));
+    for (auto id = ids.rbegin(); id != ids.rend() && result.size() < limit; ++id)
+    {
+        size_t index = lowerBound(*id);
+        if (index < size() && (*this)[index].id == *id)
+        {
+            result.push_back((*this)[index]);
+        }
+    }
+    return result;
+}
+
+size_t ActivityStore::lowerBound(int id) const
+{
+    return partitionPoint([id](const Activity& a) { return a.id < id; });
+}
+
+template <typename Less>
+size_t ActivityStore::partitionPoint(Less less) const
+{
+    size_t low = 0;
+    size_t high = size();
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (less((*this)[mid]))
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void ActivityStore::dropArchived(int through_id)
+{
+    while (!sealed_.empty() && sealed_.front().back().id <= through_id)
+    {
+        // Ids leave in the order they arrived, so each is at the front of
+        // its ticket's list
+        for (const auto& activity : sealed_.front())
+        {
+            auto it = by_ticket_.find(activity.ticket_id);
+            if (it == by_ticket_.end())
+            {
+                continue;
+            }
+            it->second.pop_front();
+            if (it->second.empty())
+            {
+                by_ticket_.erase(it);
+            }
+        }
+        sealed_.pop_front();
+    }
+}
+
+void ActivityStore::spill(Activity&& activity)
+{
+    open_batch_.push_back(std::move(activity));
+    if (open_batch_.size() == kArchiveBatch)
+    {
+        sealed_.push_back(std::move(open_batch_));
+        open_batch_.clear();
+    }
+}
+
+std::string ActivityArchive::encodeBatch(const std::vector<Activity>& batch)
+{
+    ProjectData slice;
+    slice.activities.setCapacity(batch.size());
+    for (const auto& activity : batch)
+    {
+        slice.activities.push_back(activity);
+    }
+    return BinarySnapshot::encode(slice);
+}
+
+std::string ActivityArchive::batchFileName(const std::vector<Activity>& batch)
+{
+    return kBatchPrefix + std::to_string(batch.empty() ? 0 : batch.front().id) + kBatchExtension;
+}
+
+std::vector<int> ActivityArchive::listBatches(const std::string& directory)
+{
+    std::vector<int> first_ids;
+    const std::string prefix = kBatchPrefix;
+    const std::string extension = kBatchExtension;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= prefix.size() + extension.size() ||
+            name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - extension.size(), extension.size(), extension) != 0)
+        {
+            continue;
+        }
+
+        std::string digits = name.substr(prefix.size(), name.size() - prefix.size() - extension.size());
+        if (std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        {
+            first_ids.push_back(std::stoi(digits));
+        }
+    }
+
+    std::sort(first_ids.begin(), first_ids.end());
+    return first_ids;
+}
+
+bool ActivityArchive::loadBatch(const std::string& directory, int first_id, std::vector<Activity>& out)
+{
+    ProjectData slice;
+    slice.activities.setCapacity(ActivityStore::kArchiveBatch);
+    std::string path = directory + "/" + kBatchPrefix + std::to_string(first_id) + kBatchExtension;
+    if (!BinarySnapshot::load(path, slice))
+    {
+        return false;
+    }
+    out.assign(slice.activities.begin(), slice.activities.end());
+    return true;
+}
@@ -0,0 +1,103 @@
+#include "AtomicFile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool AtomicFile::write(const std::string& path, const std::string& bytes)
+{
+    std::string temp_path = path + ".tmp";
+    HANDLE file = CreateFileA(temp_path.c_str(), GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    size_t written = 0;
+    bool ok = true;
+    while (ok && written < bytes.size())
+    {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(bytes.size() - written, 1u << 30));
+        DWORD done = 0;
+        ok = WriteFile(file, bytes.data() + written, chunk, &done, nullptr) && done > 0;
+        written += done;
+    }
+    ok = ok && FlushFileBuffers(file);
+    CloseHandle(file);
+
+    if (!ok || !MoveFileExA(temp_path.c_str(), path.c_str(),
+                            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        DeleteFileA(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void AtomicFile::syncDirectory(const std::string&)
+{
+}
+
+#else
+
+bool AtomicFile::write(const std::string& path, const std::string& bytes)
+{
+    std::string temp_path = path + ".tmp";
+    int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    size_t written = 0;
+    bool ok = true;
+    while (ok && written < bytes.size())
+    {
+        ssize_t done = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (done < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        ok = done > 0;
+        written += ok ? static_cast<size_t>(done) : 0;
+    }
+    ok = ok && fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+
+    if (!ok || std::rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+        ::unlink(temp_path.c_str());
+        return false;
+    }
+
+    // Persist the rename itself; without this the directory entry can still
+    // point at the old file after a power loss
+    syncDirectory(path);
+    return true;
+}
+
+void AtomicFile::syncDirectory(const std::string& path)
+{
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    int dir_fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (dir_fd >= 0)
+    {
+        fsync(dir_fd);
+        ::close(dir_fd);
+    }
+}
+
+#endif
@@ -0,0 +1,538 @@
+//BinarySnapshot.cpp
+#include "BinarySnapshot.hpp"
+#include "AtomicFile.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    const char kMagic[8] = { 'R', 'S', 'C', 'R', 'U', 'M', 'P', 'J' };
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        int32_t next_user_id;
+        int32_t next_ticket_id;
+        int32_t next_sprint_id;
+        int32_t next_activity_id;
+        uint64_t strings_offset;
+        uint64_t users_offset;
+        uint64_t tickets_offset;
+        uint64_t sprints_offset;
+        uint64_t activities_offset;
+        uint64_t ticket_index_offset;   // version 2+
+    };
+
+    // Version 1 headers end before ticket_index_offset
+    const size_t kHeaderSizeV1 = 72;
+
+    // On-disk records. Explicit reserved fields keep them free of
+    // compiler padding so the files are byte-for-byte reproducible.
+    struct UserRecord
+    {
+        int32_t id;
+        uint32_t username;
+        uint32_t password;
+        uint32_t role;
+        int64_t created_at;
+    };
+
+    struct TicketRecord
+    {
+        int32_t id;
+        uint32_t title;
+        uint32_t description;
+        uint32_t status;
+        uint32_t priority;
+        uint32_t type;
+        int32_t assignee_id;
+        int32_t sprint_id;
+        int32_t story_points;
+        uint32_t reserved;
+        int64_t created_at;
+        int64_t updated_at;
+    };
+
+    struct SprintRecord
+    {
+        int32_t id;
+        uint32_t name;
+        uint32_t goal;
+        uint32_t status;
+        int64_t start_date;
+        int64_t end_date;
+    };
+
+    struct ActivityRecord
+    {
+        int32_t id;
+        int32_t ticket_id;
+        int32_t user_id;
+        uint32_t action;
+        uint32_t description;
+        uint32_t reserved;
+        int64_t timestamp;
+    };
+
+    struct TicketIndexEntry
+    {
+        int32_t id;
+        uint32_t slot;
+    };
+
+    static_assert(sizeof(Header) == 80, "snapshot header must not be padded");
+    static_assert(sizeof(UserRecord) == 24, "user record must not be padded");
+    static_assert(sizeof(TicketRecord) == 56, "ticket record must not be padded");
+    static_assert(sizeof(SprintRecord) == 32, "sprint record must not be padded");
+    static_assert(sizeof(ActivityRecord) == 32, "activity record must not be padded");
+    static_assert(sizeof(TicketIndexEntry) == 8, "index entry must not be padded");
+
+    template <typename T>
+    void appendPod(std::string& out, const T& value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readPod(const char* bytes, size_t size, uint64_t offset, T& out)
+    {
+        if (offset > size || size - offset < sizeof(T))
+        {
+            return false;
+        }
+        std::memcpy(&out, bytes + offset, sizeof(T));
+        return true;
+    }
+
+    class StringTableWriter
+    {
+    public:
+        uint32_t intern(const std::string& value)
+        {
+            auto inserted = ids_.emplace(value, static_cast<uint32_t>(order_.size()));
+            if (inserted.second)
+            {
+                order_.push_back(&inserted.first->first);
+            }
+            return inserted.first->second;
+        }
+
+        std::string encode() const
+        {
+            std::string out;
+            appendPod(out, static_cast<uint32_t>(order_.size()));
+
+            uint32_t offset = 0;
+            appendPod(out, offset);
+            for (const std::string* value : order_)
+            {
+                offset += static_cast<uint32_t>(value->size());
+                appendPod(out, offset);
+            }
+            for (const std::string* value : order_)
+            {
+                out += *value;
+            }
+            return out;
+        }
+
+    private:
+        std::unordered_map<std::string, uint32_t> ids_;
+        std::vector<const std::string*> order_;
+    };
+
+    template <typename Record, typename Records, typename Convert>
+    std::string encodeSection(const Records& records, Convert convert)
+    {
+        std::string out;
+        out.reserve(sizeof(uint32_t) + records.size() * sizeof(Record));
+        appendPod(out, static_cast<uint32_t>(records.size()));
+        for (const auto& record : records)
+        {
+            appendPod(out, convert(record));
+        }
+        return out;
+    }
+
+    bool readHeader(const char* bytes, size_t size, Header& header)
+    {
+        if (size < kHeaderSizeV1)
+        {
+            return false;
+        }
+
+        header = Header{};
+        std::memcpy(&header, bytes, kHeaderSizeV1);
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+            header.version == 0 || header.version > BinarySnapshot::kVersion)
+        {
+            return false;
+        }
+        return header.version < 2 || readPod(bytes, size, 0, header);
+    }
+
+    bool decodeTicket(const SnapshotStringTable& strings, const TicketRecord& r, Ticket& t)
+    {
+        t.id = r.id;
+        t.assignee_id = r.assignee_id;
+        t.sprint_id = r.sprint_id;
+        t.story_points = r.story_points;
+        t.created_at = static_cast<time_t>(r.created_at);
+        t.updated_at = static_cast<time_t>(r.updated_at);
+
+        // The file keeps the string forms; unknown values fall back to the
+        // Ticket defaults
+        std::string status, priority, type;
+        if (!strings.get(r.title, t.title) ||
+            !strings.get(r.description, t.description) ||
+            !strings.get(r.status, status) ||
+            !strings.get(r.priority, priority) ||
+            !strings.get(r.type, type))
+        {
+            return false;
+        }
+        parseTicketStatus(status, t.status);
+        parseTicketPriority(priority, t.priority);
+        parseTicketType(type, t.type);
+        return true;
+    }
+
+    template <typename Record, typename Target, typename Convert>
+    bool decodeSection(const char* bytes, size_t size, uint64_t offset,
+                       std::vector<Target>& out, Convert convert)
+    {
+        uint32_t count = 0;
+        if (!readPod(bytes, size, offset, count))
+        {
+            return false;
+        }
+        uint64_t first = offset + sizeof(uint32_t);
+        if (size - first < static_cast<uint64_t>(count) * sizeof(Record))
+        {
+            return false;
+        }
+
+        out.clear();
+        out.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Record record;
+            std::memcpy(&record, bytes + first + i * sizeof(Record), sizeof(Record));
+            Target target;
+            if (!convert(record, target))
+            {
+                return false;
+            }
+            out.push_back(std::move(target));
+        }
+        return true;
+    }
+}
+
+std::string BinarySnapshot::encode(const ProjectData& data)
+{
+    StringTableWriter strings;
+
+    std::string users = encodeSection<UserRecord>(data.users, [&strings](const User& u) {
+        UserRecord r{};
+        r.id = u.id;
+        r.username = strings.intern(u.username);
+        r.password = strings.intern(u.password);
+        r.role = strings.intern(u.role);
+        r.created_at = static_cast<int64_t>(u.created_at);
+        return r;
+    });
+
+    std::string tickets = encodeSection<TicketRecord>(data.tickets, [&strings](const Ticket& t) {
+        TicketRecord r{};
+        r.id = t.id;
+        r.title = strings.intern(t.title);
+        r.description = strings.intern(t.description);
+        r.status = strings.intern(toString(t.status));
+        r.priority = strings.intern(toString(t.priority));
+        r.type = strings.intern(toString(t.type));
+        r.assignee_id = t.assignee_id;
+        r.sprint_id = t.sprint_id;
+        r.story_points = t.story_points;
+        r.created_at = static_cast<int64_t>(t.created_at);
+        r.updated_at = static_cast<int64_t>(t.updated_at);
+        return r;
+    });
+
+    std::string sprints = encodeSection<SprintRecord>(data.sprints, [&strings](const Sprint& s) {
+        SprintRecord r{};
+        r.id = s.id;
+        r.name = strings.intern(s.name);
+        r.goal = strings.intern(s.goal);
+        r.status = strings.intern(s.status);
+        r.start_date = static_cast<int64_t>(s.start_date);
+        r.end_date = static_cast<int64_t>(s.end_date);
+        return r;
+    });
+
+    std::string activities = encodeSection<ActivityRecord>(data.activities, [&strings](const Activity& a) {
+        ActivityRecord r{};
+        r.id = a.id;
+        r.ticket_id = a.ticket_id;
+        r.user_id = a.user_id;
+        r.action = strings.intern(a.action);
+        r.description = strings.intern(a.description);
+        r.timestamp = static_cast<int64_t>(a.timestamp);
+        return r;
+    });
+
+    std::vector<TicketIndexEntry> index;
+    index.reserve(data.tickets.size());
+    for (size_t slot = 0; slot < data.tickets.size(); ++slot)
+    {
+        index.push_back({ data.tickets[slot].id, static_cast<uint32_t>(slot) });
+    }
+    std::sort(index.begin(), index.end(),
+              [](const TicketIndexEntry& a, const TicketIndexEntry& b) { return a.id < b.id; });
+
+    std::string ticket_index;
+    ticket_index.reserve(sizeof(uint32_t) + index.size() * sizeof(TicketIndexEntry));
+    appendPod(ticket_index, static_cast<uint32_t>(index.size()));
+    for (const auto& entry : index)
+    {
+        appendPod(ticket_index, entry);
+    }
+
+    std::string string_table = strings.encode();
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.next_user_id = data.next_user_id;
+    header.next_ticket_id = data.next_ticket_id;
+    header.next_sprint_id = data.next_sprint_id;
+    header.next_activity_id = data.next_activity_id;
+    header.strings_offset = sizeof(Header);
+    header.users_offset = header.strings_offset + string_table.size();
+    header.tickets_offset = header.users_offset + users.size();
+    header.sprints_offset = header.tickets_offset + tickets.size();
+    header.activities_offset = header.sprints_offset + sprints.size();
+    header.ticket_index_offset = header.activities_offset + activities.size();
+
+    std::string out;
+    out.reserve(header.ticket_index_offset + ticket_index.size());
+    appendPod(out, header);
+    out += string_table;
+    out += users;
+    out += tickets;
+    out += sprints;
+    out += activities;
+    out += ticket_index;
+    return out;
+}
+
+namespace
+{
+    // Decodes every section except tickets
+    bool decodeSmallSections(const char* bytes, size_t size, const Header& header,
+                             const SnapshotStringTable& strings, ProjectData& data)
+    {
+        std::vector<Activity> activities;
+        bool ok =
+            decodeSection<UserRecord>(bytes, size, header.users_offset, data.users,
+                [&strings](const UserRecord& r, User& u) {
+                    u.id = r.id;
+                    u.created_at = static_cast<time_t>(r.created_at);
+                    return strings.get(r.username, u.username) &&
+                           strings.get(r.password, u.password) &&
+                           strings.get(r.role, u.role);
+                }) &&
+            decodeSection<SprintRecord>(bytes, size, header.sprints_offset, data.sprints,
+                [&strings](const SprintRecord& r, Sprint& s) {
+                    s.id = r.id;
+                    s.start_date = static_cast<time_t>(r.start_date);
+                    s.end_date = static_cast<time_t>(r.end_date);
+                    return strings.get(r.name, s.name) &&
+                           strings.get(r.goal, s.goal) &&
+                           strings.get(r.status, s.status);
+                }) &&
+            decodeSection<ActivityRecord>(bytes, size, header.activities_offset, activities,
+                [&strings](const ActivityRecord& r, Activity& a) {
+                    a.id = r.id;
+                    a.ticket_id = r.ticket_id;
+                    a.user_id = r.user_id;
+                    a.timestamp = static_cast<time_t>(r.timestamp);
+                    return strings.get(r.action, a.action) &&
+                           strings.get(r.description, a.description);
+                });
+
+        if (!ok)
+        {
+            return false;
+        }
+
+        data.activities.assign(std::move(activities));
+        data.next_user_id = header.next_user_id;
+        data.next_ticket_id = header.next_ticket_id;
+        data.next_sprint_id = header.next_sprint_id;
+        data.next_activity_id = header.next_activity_id;
+        data.format = SnapshotFormat::Binary;
+        return true;
+    }
+}
+
+bool BinarySnapshot::decode(const char* bytes, size_t size, ProjectData& data)
+{
+    Header header;
+    SnapshotStringTable strings;
+    if (!readHeader(bytes, size, header) ||
+        !strings.open(bytes, size, header.strings_offset, header.users_offset))
+    {
+        return false;
+    }
+
+    return decodeSmallSections(bytes, size, header, strings, data) &&
+        decodeSection<TicketRecord>(bytes, size, header.tickets_offset, data.tickets,
+            [&strings](const TicketRecord& r, Ticket& t) { return decodeTicket(strings, r, t); });
+}
+
+bool BinarySnapshot::save(const std::string& path, const ProjectData& data)
+{
+    return AtomicFile::write(path, encode(data));
+}
+
+bool BinarySnapshot::load(const std::string& path, ProjectData& data)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return decode(bytes.data(), bytes.size(), data);
+}
+
+bool BinarySnapshot::loadLazy(const std::string& path, ProjectData& data)
+{
+    auto file = std::make_unique<MappedFile>();
+    if (!file->open(path))
+    {
+        return false;
+    }
+
+    const char* bytes = file->data();
+    size_t size = file->size();
+
+    Header header;
+    SnapshotStringTable strings;
+    uint32_t ticket_count = 0;
+    uint32_t index_count = 0;
+    if (!readHeader(bytes, size, header) || header.version < 2 ||
+        !strings.open(bytes, size, header.strings_offset, header.users_offset) ||
+        !readPod(bytes, size, header.tickets_offset, ticket_count) ||
+        !readPod(bytes, size, header.ticket_index_offset, index_count) ||
+        index_count != ticket_count ||
+        size - header.tickets_offset - sizeof(uint32_t) < static_cast<uint64_t>(ticket_count) * sizeof(TicketRecord) ||
+        size - header.ticket_index_offset - sizeof(uint32_t) < static_cast<uint64_t>(index_count) * sizeof(TicketIndexEntry))
+    {
+        return false;
+    }
+
+    if (!decodeSmallSections(bytes, size, header, strings, data))
+    {
+        return false;
+    }
+
+    data.tickets.clear();
+    data.lazy_tickets = std::make_shared<LazyTicketTable>(
+        std::move(file), strings, header.tickets_offset, ticket_count, header.ticket_index_offset);
+    return true;
+}
+
+bool BinarySnapshot::isBinarySnapshot(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool SnapshotStringTable::open(const char* bytes, size_t size, uint64_t offset, uint64_t end)
+{
+    if (end > size || !readPod(bytes, size, offset, count_))
+    {
+        return false;
+    }
+    offsets_ = offset + sizeof(uint32_t);
+    blob_ = offsets_ + (static_cast<uint64_t>(count_) + 1) * sizeof(uint32_t);
+    if (blob_ > end)
+    {
+        return false;
+    }
+    bytes_ = bytes;
+    blob_size_ = end - blob_;
+    return true;
+}
+
+bool SnapshotStringTable::get(uint32_t id, std::string& out) const
+{
+    if (id >= count_)
+    {
+        return false;
+    }
+    uint32_t begin = 0;
+    uint32_t finish = 0;
+    std::memcpy(&begin, bytes_ + offsets_ + id * sizeof(uint32_t), sizeof(uint32_t));
+    std::memcpy(&finish, bytes_ + offsets_ + (id + 1) * sizeof(uint32_t), sizeof(uint32_t));
+    if (begin > finish || finish > blob_size_)
+    {
+        return false;
+    }
+    out.assign(bytes_ + blob_ + begin, finish - begin);
+    return true;
+}
+
+LazyTicketTable::LazyTicketTable(std::unique_ptr<MappedFile> file, const SnapshotStringTable& strings,
+                                 uint64_t tickets_offset, uint32_t count, uint64_t index_offset)
+    : file_(std::move(file)),
+      strings_(strings),
+      first_record_(tickets_offset + sizeof(uint32_t)),
+      count_(count),
+      first_index_entry_(index_offset + sizeof(uint32_t))
+{
+}
+
+bool LazyTicketTable::ticketAt(size_t slot, Ticket& out) const
+{
+    if (slot >= count_)
+    {
+        return false;
+    }
+    TicketRecord record;
+    std::memcpy(&record, file_->data() + first_record_ + slot * sizeof(TicketRecord), sizeof(TicketRecord));
+    return decodeTicket(strings_, record, out);
+}
+
+bool LazyTicketTable::findTicket(int id, Ticket& out) const
+{
+    // Binary search over the mapped (id, slot) index
+    size_t low = 0;
+    size_t high = count_;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        TicketIndexEntry entry;
+        std::memcpy(&entry, file_->data() + first_index_entry_ + mid * sizeof(TicketIndexEntry), sizeof(entry));
+        if (entry.id == id)
+        {
+            return ticketAt(entry.slot, out);
+        }
+        if (entry.id < id)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return false;
+}
@@ -1,12 +1,133 @@
-﻿#include "UIManager.hpp"
-#include "DatabaseManager.hpp"
+﻿#include "DatabaseManager.hpp"
 #include "TicketManager.hpp"
 #include "SprintManager.hpp"
 #include "models.hpp"
+#include "BinarySnapshot.hpp"
+#include "AtomicFile.hpp"
+#include "SegmentedSnapshot.hpp"
+#include "JsonSnapshotReader.hpp"
+#include "ActivityStore.hpp"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
 #include <filesystem>
+#include <iterator>
+#include <stdexcept>
+#include <future>
+#include <optional>
+
+namespace
+{
+    // DatabaseManager guards held by this thread
+    thread_local int held_reads = 0;
+    thread_local int held_writes = 0;
+
+    // Waits for a save queued under a lock the caller has since released.
+    // An invalid future means nothing was queued.
+    bool awaitSave(std::future<bool>& saved)
+    {
+        // Waiting on the disk under a lock would stall every reader with it
+        if (held_reads > 0 || held_writes > 0)
+        {
+            throw std::logic_error("DatabaseManager: save awaited under a lock");
+        }
+        return saved.valid() && saved.get();
+    }
+
+    ChangeEntity changeEntity(const std::string& entity)
+    {
+        if (entity == "user") return ChangeEntity::User;
+        if (entity == "ticket") return ChangeEntity::Ticket;
+        if (entity == "sprint") return ChangeEntity::Sprint;
+        return ChangeEntity::Activity;
+    }
+
+    // Slot helpers shared by the user/ticket/sprint tables. Each table keeps an
+    // id -> slot map next to its vector so point lookups never scan.
+    template <typename Record>
+    Record* findRecord(std::vector<Record>& records,
+                       const std::unordered_map<int, size_t>& slots, int id)
+    {
+        auto it = slots.find(id);
+        return it != slots.end() ? &records[it->second] : nullptr;
+    }
+
+    template <typename Record>
+    void insertRecord(std::vector<Record>& records,
+                      std::unordered_map<int, size_t>& slots, const Record& record)
+    {
+        slots[record.id] = records.size();
+        records.push_back(record);
+    }
+
+    // Leaves a tombstone (a default record, id 0) in the erased slot, so no
+    // other record moves; dropTombstones() squeezes them out later.
+    template <typename Record>
+    void eraseRecord(std::vector<Record>& records,
+                     std::unordered_map<int, size_t>& slots, size_t& erased, int id)
+    {
+        auto it = slots.find(id);
+        records[it->second] = Record();
+        slots.erase(it);
+        ++erased;
+    }
+
+    // One pass that drops the tombstones and moves the live records down,
+    // keeping their order. Returns whether there was anything to drop.
+    template <typename Record>
+    bool dropTombstones(std::vector<Record>& records,
+                        std::unordered_map<int, size_t>& slots, size_t& erased)
+    {
+        if (erased == 0)
+        {
+            return false;
+        }
+
+        size_t kept = 0;
+        for (size_t slot = 0; slot < records.size(); ++slot)
+        {
+            if (records[slot].id == 0)
+            {
+                continue;
+            }
+            if (kept != slot)
+            {
+                records[kept] = std::move(records[slot]);
+                slots[records[kept].id] = kept;
+            }
+            ++kept;
+        }
+        records.erase(records.begin() + static_cast<std::ptrdiff_t>(kept), records.end());
+        erased = 0;
+        return true;
+    }
+
+    template <typename Record>
+    void upsertRecord(std::vector<Record>& records,
+                      std::unordered_map<int, size_t>& slots, const Record& record)
+    {
+        if (Record* existing = findRecord(records, slots, record.id))
+        {
+            *existing = record;
+        }
+        else
+        {
+            insertRecord(records, slots, record);
+        }
+    }
+
+    template <typename Record>
+    void indexRecords(const std::vector<Record>& records,
+                      std::unordered_map<int, size_t>& slots)
+    {
+        slots.clear();
+        slots.reserve(records.size());
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            slots[records[i].id] = i;
+        }
+    }
+}
 
 DatabaseManager& DatabaseManager::getInstance()
 {
@@ -14,8 +135,535 @@ DatabaseManager& DatabaseManager::getInstance()
     return instance;
 }
 
+DatabaseManager::ReadLock::ReadLock(const DatabaseManager& db)
+    : db_(&db),
+      locked_(held_reads == 0 && held_writes == 0)
+{
+    if (locked_)
+    {
+        // Wait behind any writer that is waiting
+        db.write_gate_.lock();
+        db.write_gate_.unlock();
+        db.mutex_.lock_shared();
+    }
+    ++held_reads;
+}
+
+DatabaseManager::ReadLock::ReadLock(ReadLock&& other) noexcept
+    : db_(other.db_),
+      locked_(other.locked_)
+{
+    other.db_ = nullptr;
+    other.locked_ = false;
+}
+
+DatabaseManager::ReadLock::~ReadLock()
+{
+    if (!db_)
+    {
+        return;
+    }
+    --held_reads;
+    if (locked_)
+    {
+        db_->mutex_.unlock_shared();
+    }
+}
+
+DatabaseManager::WriteLock::WriteLock(const DatabaseManager& db)
+    : db_(db),
+      locked_(held_writes == 0)
+{
+    // Waiting for exclusive access while sharing it would never end
+    if (locked_ && held_reads > 0)
+    {
+        throw std::logic_error("DatabaseManager: write attempted under a read lock");
+    }
+    if (locked_)
+    {
+        std::lock_guard<std::mutex> gate(db.write_gate_);
+        db.mutex_.lock();
+    }
+    ++held_writes;
+}
+
+DatabaseManager::WriteLock::~WriteLock()
+{
+    --held_writes;
+    if (!locked_)
+    {
+        return;
+    }
+    std::vector<ChangeEvent> changes;
+    changes.swap(db_.pending_changes_);
+    db_.mutex_.unlock();
+    db_.deliverChanges(changes);
+}
+
+bool DatabaseManager::ticketsReady(const ProjectData& data, const TicketNeeds& needs)
+{
+    return (!needs.decoded || !data.lazy_tickets) && recordsCompacted(data) &&
+           (!needs.trigram || data.trigram_index.built()) &&
+           (!needs.search || data.search_index.built()) &&
+           (needs.order == TicketQuery::Order::None || data.order_index.built(needs.order)) &&
+           (!needs.tables || data.tables.built);
+}
+
+void DatabaseManager::prepareTickets(ProjectData& data, const TicketNeeds& needs)
+{
+    if (needs.decoded)
+    {
+        materializeTickets(data);
+    }
+    compactRecords(data);
+    if (needs.trigram && !data.trigram_index.built())
+    {
+        data.trigram_index.build(data.tickets);
+    }
+    if (needs.search && !data.search_index.built())
+    {
+        data.search_index.build(data.tickets);
+    }
+    if (needs.order != TicketQuery::Order::None && !data.order_index.built(needs.order))
+    {
+        data.order_index.build(needs.order, data.tickets);
+    }
+    if (needs.tables && !data.tables.built)
+    {
+        buildTables(data);
+    }
+}
+
+DatabaseManager::ReadLock DatabaseManager::readTickets(const TicketNeeds& needs) const
+{
+    // A write may slip in between the two locks and switch projects, so
+    // check again once reading
+    while (true)
+    {
+        {
+            ReadLock lock(*this);
+            if (!current_data_ || ticketsReady(*current_data_, needs))
+            {
+                return lock;
+            }
+        }
+        WriteLock lock(*this);
+        if (current_data_)
+        {
+            prepareTickets(*current_data_, needs);
+        }
+    }
+}
+
+DatabaseManager::ReadLock DatabaseManager::readRecords() const
+{
+    TicketNeeds needs;
+    needs.decoded = false;
+    return readTickets(needs);
+}
+
+bool DatabaseManager::recordsCompacted(const ProjectData& data)
+{
+    return data.erased_users == 0 && data.erased_tickets == 0 && data.erased_sprints == 0;
+}
+
+void DatabaseManager::compactRecords(ProjectData& data)
+{
+    dropTombstones(data.users, data.user_slots, data.erased_users);
+    if (dropTombstones(data.tickets, data.ticket_slots, data.erased_tickets))
+    {
+        data.ticket_columns.assign(data.tickets);
+    }
+    dropTombstones(data.sprints, data.sprint_slots, data.erased_sprints);
+}
+
+void DatabaseManager::rebuildIndexes(ProjectData& data)
+{
+    indexRecords(data.users, data.user_slots);
+    indexRecords(data.tickets, data.ticket_slots);
+    indexRecords(data.sprints, data.sprint_slots);
+    data.ticket_columns.assign(data.tickets);
+    data.search_index.clear();
+    data.trigram_index.clear();
+    data.order_index.clear();
+
+    data.tickets_by_sprint.clear();
+    data.tickets_by_assignee.clear();
+    data.tickets_by_status.clear();
+    for (const auto& ticket : data.tickets)
+    {
+        indexTicket(data, ticket);
+    }
+}
+
+void DatabaseManager::indexTicket(ProjectData& data, const Ticket& ticket)
+{
+    data.tickets_by_sprint[ticket.sprint_id].insert(ticket.id);
+    data.tickets_by_assignee[ticket.assignee_id].insert(ticket.id);
+    data.tickets_by_status[ticket.status].insert(ticket.id);
+}
+
+void DatabaseManager::unindexTicket(ProjectData& data, const Ticket& ticket)
+{
+    auto unlink = [&ticket](auto& index, const auto& key)
+    {
+        auto it = index.find(key);
+        if (it == index.end())
+        {
+            return;
+        }
+        it->second.erase(ticket.id);
+        if (it->second.empty())
+        {
+            index.erase(it);
+        }
+    };
+
+    unlink(data.tickets_by_sprint, ticket.sprint_id);
+    unlink(data.tickets_by_assignee, ticket.assignee_id);
+    unlink(data.tickets_by_status, ticket.status);
+}
+
+// Inserts or replaces a ticket, keeping its column slot and secondary
+// indexes in step with the row
+void DatabaseManager::storeTicket(ProjectData& data, const Ticket& ticket)
+{
+    auto it = data.ticket_slots.find(ticket.id);
+    if (it != data.ticket_slots.end())
+    {
+        Ticket& existing = data.tickets[it->second];
+        unindexTicket(data, existing);
+        data.order_index.remove(existing);
+        // Most edits leave the text alone; re-indexing it is not free
+        const bool text_changed = existing.title != ticket.title || existing.description != ticket.description;
+        if (text_changed)
+        {
+            data.search_index.remove(existing);
+            data.trigram_index.remove(existing);
+        }
+        existing = ticket;
+        data.ticket_columns.set(it->second, ticket);
+        data.order_index.add(ticket);
+        if (text_changed)
+        {
+            data.search_index.add(ticket);
+            data.trigram_index.add(ticket);
+        }
+    }
+    else
+    {
+        insertRecord(data.tickets, data.ticket_slots, ticket);
+        data.ticket_columns.push_back(ticket);
+        data.order_index.add(ticket);
+        data.search_index.add(ticket);
+        data.trigram_index.add(ticket);
+    }
+    indexTicket(data, ticket);
+}
+
+void DatabaseManager::removeTicket(ProjectData& data, int id)
+{
+    auto it = data.ticket_slots.find(id);
+    if (it == data.ticket_slots.end())
+    {
+        return;
+    }
+    
+    const size_t slot = it->second;
+    unindexTicket(data, data.tickets[slot]);
+    data.search_index.remove(data.tickets[slot]);
+    data.trigram_index.remove(data.tickets[slot]);
+    data.order_index.remove(data.tickets[slot]);
+    eraseRecord(data.tickets, data.ticket_slots, data.erased_tickets, id);
+    data.ticket_columns.set(slot, data.tickets[slot]);
+}
+
+// Journal records are full-state upserts and erases, so replaying a log the
+// snapshot already absorbed (crash before the rotated log is removed) is
+// harmless.
+void DatabaseManager::applyJournalRecord(ProjectData& data, const json& record)
+{
+    const std::string op = record.value("op", "");
+    const std::string entity = record.value("entity", "");
+    
+    // Replayed edits are not in the snapshot yet, so the next save must
+    // write them before it discards the logs they came from
+    if (op == "put" || op == "erase")
+    {
+        const json& id = op == "put" ? record.at("data").at("id") : record.at("id");
+        markDirty(data, entity, id.get<int>());
+    }
+
+    if (op == "put")
+    {
+        const json& payload = record.at("data");
+        if (entity == "user")
+        {
+            User user = payload.get<User>();
+            upsertRecord(data.users, data.user_slots, user);
+            data.next_user_id = std::max(data.next_user_id, user.id + 1);
+        }
+        else if (entity == "ticket")
+        {
+            Ticket ticket = payload.get<Ticket>();
+            storeTicket(data, ticket);
+            data.next_ticket_id = std::max(data.next_ticket_id, ticket.id + 1);
+        }
+        else if (entity == "sprint")
+        {
+            Sprint sprint = payload.get<Sprint>();
+            upsertRecord(data.sprints, data.sprint_slots, sprint);
+            data.next_sprint_id = std::max(data.next_sprint_id, sprint.id + 1);
+        }
+        else if (entity == "activity")
+        {
+            Activity activity = payload.get<Activity>();
+            if (activity.id >= data.next_activity_id)
+            {
+                data.activities.push_back(activity);
+                data.next_activity_id = activity.id + 1;
+            }
+        }
+    }
+    else if (op == "erase")
+    {
+        const int id = record.at("id").get<int>();
+        if (entity == "user" && findRecord(data.users, data.user_slots, id))
+        {
+            eraseRecord(data.users, data.user_slots, data.erased_users, id);
+        }
+        else if (entity == "ticket")
+        {
+            removeTicket(data, id);
+        }
+        else if (entity == "sprint" && findRecord(data.sprints, data.sprint_slots, id))
+        {
+            eraseRecord(data.sprints, data.sprint_slots, data.erased_sprints, id);
+        }
+    }
+}
+
+void DatabaseManager::markDirty(ProjectData& data, const std::string& entity, int id)
+{
+    if (entity == "ticket")
+    {
+        data.dirty.markTicket(id);
+    }
+    else if (entity == "activity")
+    {
+        data.dirty.markActivity(id);
+    }
+    else
+    {
+        data.dirty.markMeta();
+    }
+}
+
+void DatabaseManager::journalPut(const std::string& entity, const json& record, ChangeKind kind)
+{
+    const int id = record.at("id").get<int>();
+    markDirty(*current_data_, entity, id);
+    syncTables(*current_data_, entity, id);
+    journal_.append({{"op", "put"}, {"entity", entity}, {"data", record}});
+    if (journal_.recordCount() >= journal_compaction_threshold_)
+    {
+        saveProjectAsync(current_project_);
+    }
+    publishChange(changeEntity(entity), kind, id);
+}
+
+void DatabaseManager::journalErase(const std::string& entity, int id)
+{
+    markDirty(*current_data_, entity, id);
+    syncTables(*current_data_, entity, id);
+    journal_.append({{"op", "erase"}, {"entity", entity}, {"id", id}});
+    if (journal_.recordCount() >= journal_compaction_threshold_)
+    {
+        saveProjectAsync(current_project_);
+    }
+    publishChange(changeEntity(entity), ChangeKind::Deleted, id);
+}
+
+ProjectSnapshot DatabaseManager::takeSnapshot() const
+{
+    TicketNeeds needs;
+    needs.tables = true;
+    ReadLock lock = readTickets(needs);
+    if (!current_data_)
+    {
+        return ProjectSnapshot{};
+    }
+    
+    auto state = std::make_shared<ProjectSnapshot::State>();
+    state->project_name = current_project_;
+    state->tables = current_data_->tables;
+    state->next_user_id = current_data_->next_user_id;
+    state->next_ticket_id = current_data_->next_ticket_id;
+    state->next_sprint_id = current_data_->next_sprint_id;
+    state->next_activity_id = current_data_->next_activity_id;
+    state->versions = versions_;
+    return ProjectSnapshot(std::move(state));
+}
+
+uint64_t DatabaseManager::getVersion(ChangeEntity entity) const
+{
+    ReadLock lock(*this);
+    return versions_[static_cast<size_t>(entity)];
+}
+
+int DatabaseManager::subscribe(ChangeListener listener)
+{
+    std::lock_guard<std::mutex> lock(listeners_mutex_);
+    const int subscription = next_subscription_++;
+    listeners_[subscription] = std::move(listener);
+    return subscription;
+}
+
+void DatabaseManager::unsubscribe(int subscription)
+{
+    std::lock_guard<std::mutex> lock(listeners_mutex_);
+    listeners_.erase(subscription);
+}
+
+// Called under the write lock; the event goes out when it is released
+void DatabaseManager::publishChange(ChangeEntity entity, ChangeKind kind, int id)
+{
+    pending_changes_.push_back({entity, kind, id, ++versions_[static_cast<size_t>(entity)]});
+}
+
+void DatabaseManager::deliverChanges(const std::vector<ChangeEvent>& events) const
+{
+    if (events.empty())
+    {
+        return;
+    }
+    
+    // A listener may unsubscribe itself
+    std::map<int, ChangeListener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(listeners_mutex_);
+        listeners = listeners_;
+    }
+    for (const ChangeEvent& event : events)
+    {
+        for (const auto& entry : listeners)
+        {
+            entry.second(event);
+        }
+    }
+}
+
+// Everything in the project may have changed
+void DatabaseManager::publishReload()
+{
+    for (size_t entity = 0; entity < versions_.size(); ++entity)
+    {
+        if (entity != static_cast<size_t>(ChangeEntity::Project))
+        {
+            ++versions_[entity];
+        }
+    }
+    publishChange(ChangeEntity::Project, ChangeKind::Reloaded, 0);
+}
+
+void DatabaseManager::buildTables(ProjectData& data)
+{
+    ProjectTables& tables = data.tables;
+    tables.clear();
+    for (const auto& user : data.users)
+    {
+        tables.users.put(user);
+    }
+    for (const auto& ticket : data.tickets)
+    {
+        tables.tickets.put(ticket);
+    }
+    for (const auto& sprint : data.sprints)
+    {
+        tables.sprints.put(sprint);
+    }
+    for (const auto& activity : data.activities)
+    {
+        tables.activities.put(activity);
+    }
+    tables.built = true;
+}
+
+// Copies one journaled change into the tables, once they are built
+void DatabaseManager::syncTables(ProjectData& data, const std::string& entity, int id)
+{
+    if (!data.tables.built)
+    {
+        return;
+    }
+    
+    auto sync = [id](auto& table, const auto* record)
+    {
+        if (record)
+        {
+            table.put(*record);
+        }
+        else
+        {
+            table.erase(id);
+        }
+    };
+    if (entity == "user")
+    {
+        sync(data.tables.users, findRecord(data.users, data.user_slots, id));
+    }
+    else if (entity == "ticket")
+    {
+        sync(data.tables.tickets, findRecord(data.tickets, data.ticket_slots, id));
+    }
+    else if (entity == "sprint")
+    {
+        sync(data.tables.sprints, findRecord(data.sprints, data.sprint_slots, id));
+    }
+    else
+    {
+        const size_t position = data.activities.lowerBound(id);
+        const bool held = position < data.activities.size() && data.activities[position].id == id;
+        sync(data.tables.activities, held ? &data.activities[position] : nullptr);
+    }
+}
+
+void DatabaseManager::recordActivity(const Activity& activity)
+{
+    current_data_->activities.push_back(activity);
+    journalPut("activity", activity, ChangeKind::Created);
+}
+
+void DatabaseManager::materializeTickets(ProjectData& data)
+{
+    if (!data.lazy_tickets)
+    {
+        return;
+    }
+    
+    std::shared_ptr<LazyTicketTable> table = std::move(data.lazy_tickets);
+    data.tickets.clear();
+    data.tickets.reserve(table->size());
+    for (size_t slot = 0; slot < table->size(); ++slot)
+    {
+        Ticket ticket;
+        if (table->ticketAt(slot, ticket))
+        {
+            data.tickets.push_back(std::move(ticket));
+        }
+    }
+    rebuildIndexes(data);
+}
+
+void DatabaseManager::setLazyLoading(bool enabled)
+{
+    WriteLock lock(*this);
+    lazy_loading_ = enabled;
+}
+
 bool DatabaseManager::initialize(const std::string& db_path)
 {
+    WriteLock lock(*this);
     // For retro feel, we use JSON files only
     use_sqlite_ = false;
     
@@ -27,27 +675,29 @@ bool DatabaseManager::initialize(const std::string& db_path)
 
 bool DatabaseManager::initializeDemoData()
 {
-    if (!current_data_) {
-        if (projects_.find("default") == projects_.end()) {
+    // Creating the project saves it, which is waited for outside the lock
+    if (getCurrentProjectName().empty()) {
+        if (!isProjectLoaded("default")) {
             createNewProject("default");
         }
         switchProject("default");
     }
     
+    std::optional<WriteLock> lock(std::in_place, *this);
     if (!current_data_) return false;
     
     // Create demo users
     User admin("admin", "admin", "admin");
     admin.id = current_data_->next_user_id++;
-    current_data_->users.push_back(admin);
+    insertRecord(current_data_->users, current_data_->user_slots, admin);
     
     User dev1("john", "password", "user");
     dev1.id = current_data_->next_user_id++;
-    current_data_->users.push_back(dev1);
+    insertRecord(current_data_->users, current_data_->user_slots, dev1);
     
     User dev2("jane", "password", "user");
     dev2.id = current_data_->next_user_id++;
-    current_data_->users.push_back(dev2);
+    insertRecord(current_data_->users, current_data_->user_slots, dev2);
     
     // Create demo sprint
     Sprint sprint1;
@@ -57,44 +707,44 @@ bool DatabaseManager::initializeDemoData()
     sprint1.start_date = std::time(nullptr);
     sprint1.end_date = std::time(nullptr) + (14 * 24 * 60 * 60); // 14 days from now
     sprint1.status = "active";
-    current_data_->sprints.push_back(sprint1);
+    insertRecord(current_data_->sprints, current_data_->sprint_slots, sprint1);
     
     // Create demo tickets
     Ticket ticket1;
     ticket1.id = current_data_->next_ticket_id++;
     ticket1.title = "Implement user authentication";
     ticket1.description = "Add login and user management features";
-    ticket1.status = "in_progress";
-    ticket1.priority = "high";
-    ticket1.type = "feature";
+    ticket1.status = TicketStatus::InProgress;
+    ticket1.priority = TicketPriority::High;
+    ticket1.type = TicketType::Feature;
     ticket1.assignee_id = dev1.id;
     ticket1.sprint_id = sprint1.id;
     ticket1.story_points = 5;
-    current_data_->tickets.push_back(ticket1);
+    storeTicket(*current_data_, ticket1);
     
     Ticket ticket2;
     ticket2.id = current_data_->next_ticket_id++;
     ticket2.title = "Fix navigation bug";
     ticket2.description = "Navigation breaks on small screens";
-    ticket2.status = "todo";
-    ticket2.priority = "medium";
-    ticket2.type = "bug";
+    ticket2.status = TicketStatus::Todo;
+    ticket2.priority = TicketPriority::Medium;
+    ticket2.type = TicketType::Bug;
     ticket2.assignee_id = dev2.id;
     ticket2.sprint_id = sprint1.id;
     ticket2.story_points = 3;
-    current_data_->tickets.push_back(ticket2);
+    storeTicket(*current_data_, ticket2);
     
     Ticket ticket3;
     ticket3.id = current_data_->next_ticket_id++;
     ticket3.title = "Design database schema";
     ticket3.description = "Create initial database structure";
-    ticket3.status = "done";
-    ticket3.priority = "high";
-    ticket3.type = "task";
+    ticket3.status = TicketStatus::Done;
+    ticket3.priority = TicketPriority::High;
+    ticket3.type = TicketType::Task;
     ticket3.assignee_id = admin.id;
     ticket3.sprint_id = sprint1.id;
     ticket3.story_points = 8;
-    current_data_->tickets.push_back(ticket3);
+    storeTicket(*current_data_, ticket3);
     
     // Log some activities
     Activity activity1;
@@ -114,26 +764,43 @@ bool DatabaseManager::initializeDemoData()
     activity2.description = "Assigned ticket to John";
     activity2.timestamp = std::time(nullptr) - 1800;
     current_data_->activities.push_back(activity2);
+    current_data_->dirty.all = true;
+    // Filled in directly above, so rebuilt by the next snapshot
+    current_data_->tables.clear();
     
-    return saveProject("default");
+    std::future<bool> saved = queueSave("default");
+    lock.reset();
+    return awaitSave(saved);
 }
 
 bool DatabaseManager::createNewProject(const std::string& project_name)
 {
+    std::optional<WriteLock> lock(std::in_place, *this);
     if (project_name.empty() || projects_.count(project_name) > 0)
     {
         return false;
     }
     
-    // Create fresh project data
+    // Create fresh project data and give it an on-disk snapshot right away,
+    // so the journal always has something to replay onto
     projects_[project_name] = ProjectData{};
+    projects_[project_name].format = default_format_;
+    projects_[project_name].activities.setCapacity(activity_capacity_);
+    std::future<bool> saved = queueSave(project_name);
+    lock.reset();
     
-    // Set as current project
+    // Set as current project once the snapshot is on disk
+    if (!awaitSave(saved))
+    {
+        dropUnsavedProject(project_name);
+        return false;
+    }
     return switchProject(project_name);
 }
 
 bool DatabaseManager::switchProject(const std::string& project_name)
 {
+    WriteLock lock(*this);
     auto it = projects_.find(project_name);
     if (it == projects_.end())
     {
@@ -147,83 +814,488 @@ bool DatabaseManager::switchProject(const std::string& project_name)
     
     current_project_ = project_name;
     current_data_ = &it->second;
+    journal_.open(getJournalFilePath(project_name));
+    publishReload();
     return true;
 }
 
-bool DatabaseManager::saveProject(const std::string& project_name)
+bool DatabaseManager::saveProject(const std::string& project_name)
+{
+    std::future<bool> saved;
+    {
+        WriteLock lock(*this);
+        saved = queueSave(project_name);
+    }
+    // The write itself touches nothing here, so readers need not wait on it
+    return awaitSave(saved);
+}
+
+bool DatabaseManager::saveProjectAsync(const std::string& project_name)
+{
+    WriteLock lock(*this);
+    return queueSave(project_name).valid();
+}
+
+void DatabaseManager::dropUnsavedProject(const std::string& project_name)
+{
+    WriteLock lock(*this);
+    // Kept if something switched to it while the save was pending
+    if (project_name != current_project_)
+    {
+        projects_.erase(project_name);
+    }
+}
+
+SaveStats DatabaseManager::getSaveStats() const
+{
+    return save_worker_.stats();
+}
+
+std::future<bool> DatabaseManager::queueSave(const std::string& project_name)
+{
+    auto it = projects_.find(project_name);
+    if (it == projects_.end())
+    {
+        return {};
+    }
+    
+    // Also drops the mapping before the snapshot file is replaced
+    materializeTickets(it->second);
+    compactRecords(it->second);
+    
+    auto& data = it->second;
+    
+    // Activity batches the archive already holds leave memory and the
+    // snapshot. The others are written to the archive ahead of the snapshot
+    // and stay in both until a later save sees the write confirmed.
+    int archived_through = data.archived_through->load();
+    for (const auto& batch : data.activities.sealedBatches())
+    {
+        if (batch.back().id <= archived_through)
+        {
+            data.dirty.markActivities(batch.front().id, batch.back().id);
+        }
+    }
+    data.activities.dropArchived(archived_through);
+    if (data.tables.built)
+    {
+        data.tables.activities.eraseBelow(data.activities.empty() ? data.next_activity_id : data.activities[0].id);
+    }
+    
+    std::vector<SnapshotSegment> archive;
+    int archive_through = archived_through;
+    for (const auto& batch : data.activities.sealedBatches())
+    {
+        archive.push_back({ ActivityArchive::batchFileName(batch), ActivityArchive::encodeBatch(batch) });
+        archive_through = batch.back().id;
+    }
+    std::string archive_directory = getArchiveDirectory(project_name);
+    
+    // Segmented projects encode only what changed; the single-file formats
+    // always re-encode everything
+    bool segmented = data.format == SnapshotFormat::Segmented;
+    if (data.save_failed->exchange(false))
+    {
+        data.dirty.all = true;
+    }
+    bool replace_all = data.dirty.all;
+    std::vector<SnapshotSegment> segments;
+    std::string bytes;
+    if (segmented)
+    {
+        segments = SegmentedSnapshot::encode(data, data.dirty);
+    }
+    else
+    {
+        bytes = data.format == SnapshotFormat::Binary
+            ? BinarySnapshot::encode(data)
+            : encodeJsonSnapshot(data);
+    }
+    data.dirty = DirtySegments{};
+    data.dirty.all = false;
+    std::string file_path = getProjectFilePath(project_name, data.format);
+    
+    // Snapshots left over in the other formats are dropped so auto-detection
+    // cannot pick up stale data
+    std::vector<std::string> stale_paths;
+    for (SnapshotFormat other : { SnapshotFormat::Json, SnapshotFormat::Binary, SnapshotFormat::Segmented })
+    {
+        if (other != data.format)
+        {
+            stale_paths.push_back(getProjectFilePath(project_name, other));
+        }
+    }
+    
+    // Everything journaled so far is part of this snapshot. It moves to a
+    // rotated log that stays replayable until the write is durable; edits
+    // made meanwhile go to a fresh journal.
+    std::string journal_path = getJournalFilePath(project_name);
+    uint64_t generation = rotateJournal(project_name);
+    
+    return save_worker_.post([file_path, stale_paths, journal_path, generation, segmented, replace_all,
+                              failed = data.save_failed, archived = data.archived_through,
+                              archive_directory, archive_through, archive = std::move(archive),
+                              segments = std::move(segments), bytes = std::move(bytes)]
+    {
+        std::error_code error;
+        if (!archive.empty())
+        {
+            std::filesystem::create_directories(archive_directory, error);
+            for (const auto& batch : archive)
+            {
+                if (!AtomicFile::write(archive_directory + "/" + batch.name, batch.bytes))
+                {
+                    failed->store(true);
+                    return false;
+                }
+            }
+            archived->store(archive_through);
+        }
+        
+        bool written = segmented
+            ? SegmentedSnapshot::write(file_path, segments, replace_all)
+            : AtomicFile::write(file_path, bytes);
+        if (!written)
+        {
+            failed->store(true);
+            return false;
+        }
+        
+        for (const auto& stale_path : stale_paths)
+        {
+            std::filesystem::remove_all(stale_path, error);
+        }
+        for (const auto& log : ProjectJournal::rotatedLogs(journal_path))
+        {
+            if (log.first <= generation)
+            {
+                std::filesystem::remove(log.second, error);
+            }
+        }
+        return true;
+    });
+}
+
+uint64_t DatabaseManager::rotateJournal(const std::string& project_name)
+{
+    std::string journal_path = getJournalFilePath(project_name);
+    auto rotated = ProjectJournal::rotatedLogs(journal_path);
+    uint64_t generation = rotated.empty() ? 1 : rotated.back().first + 1;
+    std::string rotated_path = ProjectJournal::rotatedPath(journal_path, generation);
+    
+    if (project_name == current_project_)
+    {
+        journal_.rotate(rotated_path);
+    }
+    else
+    {
+        std::error_code error;
+        if (std::filesystem::exists(journal_path, error))
+        {
+            std::filesystem::rename(journal_path, rotated_path, error);
+        }
+    }
+    return generation;
+}
+
+bool DatabaseManager::loadProject(const std::string& project_name)
+{
+    WriteLock lock(*this);
+    ProjectData data;
+    if (!readProject(project_name, data, false))
+    {
+        return false;
+    }
+    installProject(project_name, std::move(data));
+    return true;
+}
+
+void DatabaseManager::installProject(const std::string& project_name, ProjectData data)
+{
+    WriteLock lock(*this);
+    projects_[project_name] = std::move(data);
+    if (current_data_ && project_name == current_project_)
+    {
+        publishReload();
+    }
+}
+
+bool DatabaseManager::isProjectLoaded(const std::string& project_name) const
+{
+    ReadLock lock(*this);
+    return projects_.count(project_name) != 0;
+}
+
+bool DatabaseManager::readProject(const std::string& project_name, ProjectData& data, bool materialize) const
+{
+    bool lazy_loading = false;
+    {
+        ReadLock lock(*this);
+        lazy_loading = lazy_loading_;
+        data.activities.setCapacity(activity_capacity_);
+    }
+    
+    std::string file_path = getProjectFilePath(project_name);
+    if (!std::filesystem::exists(file_path))
+    {
+        return false;
+    }
+    
+    bool loaded = false;
+    if (std::filesystem::is_directory(file_path))
+    {
+        loaded = SegmentedSnapshot::load(file_path, data);
+    }
+    else if (BinarySnapshot::isBinarySnapshot(file_path))
+    {
+        // Map lazily only when there is no journal to roll forward; replay
+        // would touch tickets and force them all in anyway
+        std::string journal_path = getJournalFilePath(project_name);
+        bool journal_empty = ProjectJournal::rotatedLogs(journal_path).empty() &&
+                             (!std::filesystem::exists(journal_path) ||
+                              std::filesystem::file_size(journal_path) == 0);
+        loaded = (lazy_loading && journal_empty && BinarySnapshot::loadLazy(file_path, data)) ||
+                 BinarySnapshot::load(file_path, data);
+    }
+    else
+    {
+        loaded = loadJsonSnapshot(file_path, data);
+    }
+    
+    if (!loaded)
+    {
+        std::cerr << "Error loading project: " << file_path << std::endl;
+        return false;
+    }
+    
+    rebuildIndexes(data);
+    
+    try
+    {
+        // Roll forward edits made since the snapshot was written: first any
+        // logs rotated by a background save that never finished, oldest
+        // first, then the live journal
+        auto apply = [&data](const json& record) { applyJournalRecord(data, record); };
+        std::string journal_path = getJournalFilePath(project_name);
+        for (const auto& log : ProjectJournal::rotatedLogs(journal_path))
+        {
+            ProjectJournal::replay(log.second, apply);
+        }
+        ProjectJournal::replay(journal_path, apply);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error replaying journal: " << e.what() << std::endl;
+        return false;
+    }
+    compactRecords(data);
+    
+    if (materialize)
+    {
+        materializeTickets(data);
+    }
+    return true;
+}
+
+std::string DatabaseManager::encodeJsonSnapshot(const ProjectData& data, const std::vector<Activity>& archived)
+{
+    json project_data;
+    
+    project_data["users"] = data.users;
+    project_data["tickets"] = data.tickets;
+    project_data["sprints"] = data.sprints;
+    
+    // Archived entries the project still holds in memory are written once
+    int in_memory_from = data.activities.empty() ? data.next_activity_id : data.activities[0].id;
+    std::vector<Activity> activities;
+    for (const auto& activity : archived)
+    {
+        if (activity.id < in_memory_from)
+        {
+            activities.push_back(activity);
+        }
+    }
+    activities.insert(activities.end(), data.activities.begin(), data.activities.end());
+    project_data["activities"] = std::move(activities);
+    project_data["next_ids"] = {
+        {"user", data.next_user_id},
+        {"ticket", data.next_ticket_id},
+        {"sprint", data.next_sprint_id},
+        {"activity", data.next_activity_id}
+    };
+    
+    return project_data.dump(4);
+}
+
+bool DatabaseManager::saveJsonSnapshot(const std::string& file_path, const ProjectData& data,
+                                       const std::vector<Activity>& archived)
+{
+    return AtomicFile::write(file_path, encodeJsonSnapshot(data, archived));
+}
+
+bool DatabaseManager::loadArchivedActivities(const std::string& project_name, std::vector<Activity>& out)
+{
+    std::string directory = getArchiveDirectory(project_name);
+    for (int first_id : ActivityArchive::listBatches(directory))
+    {
+        std::vector<Activity> batch;
+        if (!ActivityArchive::loadBatch(directory, first_id, batch))
+        {
+            return false;
+        }
+        out.insert(out.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+    }
+    return true;
+}
+
+bool DatabaseManager::loadJsonSnapshot(const std::string& file_path, ProjectData& data)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    
+    if (!file.is_open())
+    {
+        return false;
+    }
+    
+    std::string error;
+    if (!JsonSnapshotReader::read(file, data, error))
+    {
+        std::cerr << "Error loading project: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::setProjectFormat(const std::string& project_name, SnapshotFormat format)
+{
+    std::future<bool> saved;
+    {
+        WriteLock lock(*this);
+        auto it = projects_.find(project_name);
+        if (it == projects_.end())
+        {
+            return false;
+        }
+        
+        it->second.format = format;
+        it->second.dirty.all = true;
+        saved = queueSave(project_name);
+    }
+    return awaitSave(saved);
+}
+
+void DatabaseManager::setDefaultProjectFormat(SnapshotFormat format)
 {
-    auto it = projects_.find(project_name);
-    if (it == projects_.end())
+    WriteLock lock(*this);
+    default_format_ = format;
+}
+
+bool DatabaseManager::exportProjectJson(const std::string& project_name, const std::string& file_path)
+{
+    // The current project is written from a snapshot, so edits go on while
+    // it is encoded
+    if (project_name == getCurrentProjectName())
     {
-        return false;
+        ProjectSnapshot snapshot = takeSnapshot();
+        if (snapshot.projectName() == project_name)
+        {
+            ProjectData data;
+            snapshot.copyTo(data);
+            // Read after the snapshot is taken, so it reaches at least as
+            // far as the entries the snapshot no longer holds
+            std::vector<Activity> archived;
+            if (!loadArchivedActivities(project_name, archived))
+            {
+                return false;
+            }
+            return saveJsonSnapshot(file_path, data, archived);
+        }
     }
     
-    json project_data;
-    auto& data = it->second;
-    
-    project_data["users"] = data.users;
-    project_data["tickets"] = data.tickets;
-    project_data["sprints"] = data.sprints;
-    project_data["activities"] = data.activities;
-    project_data["next_ids"] = {
-        {"user", data.next_user_id},
-        {"ticket", data.next_ticket_id},
-        {"sprint", data.next_sprint_id},
-        {"activity", data.next_activity_id}
-    };
-    
-    std::string file_path = getProjectFilePath(project_name);
-    std::ofstream file(file_path);
+    // Any other project is copied under a read lock and encoded after it,
+    // so edits are not held up by the export either. Lazy tickets are read
+    // from the mapping and tombstones skipped, leaving the project as it is.
+    ProjectData data;
+    {
+        ReadLock lock(*this);
+        auto it = projects_.find(project_name);
+        if (it == projects_.end())
+        {
+            return false;
+        }
+        
+        const ProjectData& project = it->second;
+        auto live = [](const auto& record) { return record.id != 0; };
+        std::copy_if(project.users.begin(), project.users.end(), std::back_inserter(data.users), live);
+        std::copy_if(project.sprints.begin(), project.sprints.end(), std::back_inserter(data.sprints), live);
+        if (project.lazy_tickets)
+        {
+            data.tickets.reserve(project.lazy_tickets->size());
+            for (size_t slot = 0; slot < project.lazy_tickets->size(); ++slot)
+            {
+                Ticket ticket;
+                if (project.lazy_tickets->ticketAt(slot, ticket))
+                {
+                    data.tickets.push_back(std::move(ticket));
+                }
+            }
+        }
+        else
+        {
+            data.tickets.reserve(project.tickets.size() - project.erased_tickets);
+            std::copy_if(project.tickets.begin(), project.tickets.end(), std::back_inserter(data.tickets), live);
+        }
+        data.activities.setCapacity(activity_capacity_);
+        data.activities.assign(std::vector<Activity>(project.activities.begin(), project.activities.end()));
+        data.next_user_id = project.next_user_id;
+        data.next_ticket_id = project.next_ticket_id;
+        data.next_sprint_id = project.next_sprint_id;
+        data.next_activity_id = project.next_activity_id;
+    }
     
-    if (!file.is_open())
+    // Read after the copy, for the same reason as above
+    std::vector<Activity> archived;
+    if (!loadArchivedActivities(project_name, archived))
     {
         return false;
     }
-    
-    file << project_data.dump(4);
-    return true;
+    return saveJsonSnapshot(file_path, data, archived);
 }
 
-bool DatabaseManager::loadProject(const std::string& project_name)
+bool DatabaseManager::importProjectJson(const std::string& project_name, const std::string& file_path)
 {
-    std::string file_path = getProjectFilePath(project_name);
-    std::ifstream file(file_path);
-    
-    if (!file.is_open())
+    std::optional<WriteLock> lock(std::in_place, *this);
+    if (project_name.empty() || projects_.count(project_name) > 0 ||
+        std::filesystem::exists(getProjectFilePath(project_name)))
     {
         return false;
     }
     
-    try
+    ProjectData data;
+    data.activities.setCapacity(activity_capacity_);
+    if (!loadJsonSnapshot(file_path, data))
     {
-        json project_data;
-        file >> project_data;
-        
-        ProjectData data;
-        data.users = project_data["users"].get<std::vector<User>>();
-        data.tickets = project_data["tickets"].get<std::vector<Ticket>>();
-        data.sprints = project_data["sprints"].get<std::vector<Sprint>>();
-        data.activities = project_data["activities"].get<std::vector<Activity>>();
-        
-        auto next_ids = project_data["next_ids"];
-        data.next_user_id = next_ids["user"];
-        data.next_ticket_id = next_ids["ticket"];
-        data.next_sprint_id = next_ids["sprint"];
-        data.next_activity_id = next_ids["activity"];
-        
-        projects_[project_name] = data;
-        return true;
+        return false;
     }
-    catch (const std::exception& e)
+    
+    data.format = default_format_;
+    rebuildIndexes(data);
+    projects_[project_name] = std::move(data);
+    std::future<bool> saved = queueSave(project_name);
+    lock.reset();
+    
+    if (!awaitSave(saved))
     {
-        std::cerr << "Error loading project: " << e.what() << std::endl;
+        dropUnsavedProject(project_name);
         return false;
     }
+    return true;
 }
 
 // User operations
 bool DatabaseManager::createUser(const User& user)
 {
+    WriteLock lock(*this);
     if (!current_data_)
     {
         return false;
@@ -232,7 +1304,7 @@ bool DatabaseManager::createUser(const User& user)
     // Check for duplicate username
     for (const auto& existing_user : current_data_->users)
     {
-        if (existing_user.username == user.username)
+        if (existing_user.id != 0 && existing_user.username == user.username)
         {
             return false;
         }
@@ -240,7 +1312,8 @@ bool DatabaseManager::createUser(const User& user)
     
     User new_user = user;
     new_user.id = current_data_->next_user_id++;
-    current_data_->users.push_back(new_user);
+    insertRecord(current_data_->users, current_data_->user_slots, new_user);
+    journalPut("user", new_user, ChangeKind::Created);
     
     // Log activity
     Activity activity;
@@ -249,43 +1322,49 @@ bool DatabaseManager::createUser(const User& user)
     activity.action = "user_created";
     activity.description = "Created user: " + new_user.username;
     activity.timestamp = std::time(nullptr);
-    current_data_->activities.push_back(activity);
+    recordActivity(activity);
     
     return true;
 }
 
 User DatabaseManager::getUser(int id)
 {
+    ReadLock lock(*this);
     if (!current_data_)
     {
         return User{};
     }
     
-    auto it = std::find_if(current_data_->users.begin(), current_data_->users.end(),
-                          [id](const User& u) { return u.id == id; });
-    
-    return it != current_data_->users.end() ? *it : User{};
+    User* user = findRecord(current_data_->users, current_data_->user_slots, id);
+    return user ? *user : User{};
 }
 
 std::vector<User> DatabaseManager::getAllUsers()
 {
+    ReadLock lock = readRecords();
     return current_data_ ? current_data_->users : std::vector<User>{};
 }
 
+RecordView<User> DatabaseManager::getUsersView() const
+{
+    ReadLock lock = readRecords();
+    return current_data_ ? RecordView<User>(current_data_->users) : RecordView<User>{};
+}
+
 bool DatabaseManager::updateUser(const User& user)
 {
+    WriteLock lock(*this);
     if (!current_data_)
     {
         return false;
     }
     
-    auto it = std::find_if(current_data_->users.begin(), current_data_->users.end(),
-                          [&user](const User& u) { return u.id == user.id; });
+    User* existing = findRecord(current_data_->users, current_data_->user_slots, user.id);
     
-    if (it != current_data_->users.end())
+    if (existing)
     {
-        *it = user;
-        it->updated_at = std::time(nullptr);
+        *existing = user;
+        journalPut("user", *existing, ChangeKind::Updated);
         
         // Log activity
         Activity activity;
@@ -294,7 +1373,7 @@ bool DatabaseManager::updateUser(const User& user)
         activity.action = "user_updated";
         activity.description = "Updated user: " + user.username;
         activity.timestamp = std::time(nullptr);
-        current_data_->activities.push_back(activity);
+        recordActivity(activity);
         
         return true;
     }
@@ -304,18 +1383,19 @@ bool DatabaseManager::updateUser(const User& user)
 
 bool DatabaseManager::deleteUser(int id)
 {
+    WriteLock lock(*this);
     if (!current_data_)
     {
         return false;
     }
     
-    auto it = std::find_if(current_data_->users.begin(), current_data_->users.end(),
-                          [id](const User& u) { return u.id == id; });
+    User* user = findRecord(current_data_->users, current_data_->user_slots, id);
     
-    if (it != current_data_->users.end())
+    if (user)
     {
-        std::string username = it->username;
-        current_data_->users.erase(it);
+        std::string username = user->username;
+        eraseRecord(current_data_->users, current_data_->user_slots, current_data_->erased_users, id);
+        journalErase("user", id);
         
         // Log activity
         Activity activity;
@@ -323,7 +1403,7 @@ bool DatabaseManager::deleteUser(int id)
         activity.action = "user_deleted";
         activity.description = "Deleted user: " + username;
         activity.timestamp = std::time(nullptr);
-        current_data_->activities.push_back(activity);
+        recordActivity(activity);
         
         return true;
     }
@@ -334,15 +1414,18 @@ bool DatabaseManager::deleteUser(int id)
 // Ticket operations
 bool DatabaseManager::createTicket(Ticket& ticket)
 {
+    WriteLock lock(*this);
     if (!current_data_)
     {
         return false;
     }
     
+    materializeTickets(*current_data_);
     ticket.id = current_data_->next_ticket_id++;
     ticket.created_at = std::time(nullptr);
     ticket.updated_at = std::time(nullptr);
-    current_data_->tickets.push_back(ticket);
+    storeTicket(*current_data_, ticket);
+    journalPut("ticket", ticket, ChangeKind::Created);
     
     // Log activity
     Activity activity;
@@ -351,70 +1434,329 @@ bool DatabaseManager::createTicket(Ticket& ticket)
     activity.action = "ticket_created";
     activity.description = "Created ticket: " + ticket.title;
     activity.timestamp = std::time(nullptr);
-    current_data_->activities.push_back(activity);
+    recordActivity(activity);
     
     return true;
 }
 
 Ticket DatabaseManager::getTicket(int id)
 {
+    ReadLock lock(*this);
     if (!current_data_)
     {
         return Ticket{};
     }
     
-    auto it = std::find_if(current_data_->tickets.begin(), current_data_->tickets.end(),
-                          [id](const Ticket& t) { return t.id == id; });
+    // Served straight from the mapped snapshot until tickets are materialized
+    if (current_data_->lazy_tickets)
+    {
+        Ticket ticket;
+        return current_data_->lazy_tickets->findTicket(id, ticket) ? ticket : Ticket{};
+    }
     
-    return it != current_data_->tickets.end() ? *it : Ticket{};
+    Ticket* ticket = findRecord(current_data_->tickets, current_data_->ticket_slots, id);
+    return ticket ? *ticket : Ticket{};
 }
 
 std::vector<Ticket> DatabaseManager::getAllTickets()
 {
+    ReadLock lock = readTickets({});
     return current_data_ ? current_data_->tickets : std::vector<Ticket>{};
 }
 
+RecordView<Ticket> DatabaseManager::getTicketsView() const
+{
+    ReadLock lock = readTickets({});
+    return current_data_ ? RecordView<Ticket>(current_data_->tickets) : RecordView<Ticket>{};
+}
+
+size_t DatabaseManager::getTicketCount() const
+{
+    ReadLock lock(*this);
+    if (!current_data_)
+    {
+        return 0;
+    }
+    
+    return current_data_->lazy_tickets ? current_data_->lazy_tickets->size()
+                                       : current_data_->tickets.size() - current_data_->erased_tickets;
+}
+
+std::vector<Ticket> DatabaseManager::getTicketsInRange(size_t first, size_t count) const
+{
+    ReadLock lock = readRecords();
+    std::vector<Ticket> result;
+    size_t total = getTicketCount();
+    if (first >= total)
+    {
+        return result;
+    }
+    
+    size_t last = std::min(total, first + count);
+    result.reserve(last - first);
+    for (size_t slot = first; slot < last; ++slot)
+    {
+        if (current_data_->lazy_tickets)
+        {
+            Ticket ticket;
+            if (current_data_->lazy_tickets->ticketAt(slot, ticket))
+            {
+                result.push_back(std::move(ticket));
+            }
+        }
+        else
+        {
+            result.push_back(current_data_->tickets[slot]);
+        }
+    }
+    return result;
+}
+
+void DatabaseManager::visitTickets(const TicketQuery::Visitor& visit) const
+{
+    ReadLock lock = readRecords();
+    if (!current_data_)
+    {
+        return;
+    }
+    
+    if (const auto& lazy = current_data_->lazy_tickets)
+    {
+        Ticket ticket;
+        for (size_t slot = 0; slot < lazy->size(); ++slot)
+        {
+            if (lazy->ticketAt(slot, ticket) && !visit(ticket))
+            {
+                return;
+            }
+        }
+        return;
+    }
+    for (const auto& ticket : current_data_->tickets)
+    {
+        if (!visit(ticket))
+        {
+            return;
+        }
+    }
+}
+
+void DatabaseManager::queryTickets(const TicketQuery& query, const TicketQuery::Visitor& visit)
+{
+    TicketNeeds needs;
+    needs.trigram = query.hasText();
+    needs.order = query.order();
+    ReadLock lock = readTickets(needs);
+    if (current_data_)
+    {
+        query.run(*current_data_, visit);
+    }
+}
+
+std::vector<Ticket> DatabaseManager::queryTickets(const TicketQuery& query)
+{
+    std::vector<Ticket> result;
+    queryTickets(query, [&result](const Ticket& ticket)
+    {
+        result.push_back(ticket);
+        return true;
+    });
+    return result;
+}
+
+TicketPage DatabaseManager::queryTicketPage(const TicketQuery& query, size_t page_size)
+{
+    // Pages need a stable order; unordered queries go by id. One extra
+    // ticket is fetched to learn whether another page follows.
+    TicketQuery paged = query;
+    if (paged.order() == TicketQuery::Order::None)
+    {
+        paged.orderBy(TicketQuery::Order::Id);
+    }
+    paged.limit(page_size == SIZE_MAX ? SIZE_MAX : page_size + 1);
+    
+    TicketPage page;
+    page.tickets = queryTickets(paged);
+    if (page.tickets.size() > page_size)
+    {
+        page.tickets.resize(page_size);
+        page.has_more = true;
+    }
+    if (!page.tickets.empty())
+    {
+        page.next = TicketQuery::sortKey(paged.order(), page.tickets.back());
+    }
+    return page;
+}
+
 std::vector<Ticket> DatabaseManager::getTicketsBySprint(int sprint_id)
 {
+    return queryTickets(TicketQuery().sprint(sprint_id));
+}
+
+std::vector<Ticket> DatabaseManager::getTicketsByStatus(TicketStatus status)
+{
+    return queryTickets(TicketQuery().status(status));
+}
+
+std::vector<Ticket> DatabaseManager::getTicketsByAssignee(int assignee_id)
+{
+    return queryTickets(TicketQuery().assignee(assignee_id));
+}
+
+std::vector<Ticket> DatabaseManager::searchTickets(const std::string& query, size_t limit)
+{
+    TicketNeeds needs;
+    needs.search = true;
+    ReadLock lock = readTickets(needs);
     if (!current_data_)
     {
         return std::vector<Ticket>{};
     }
     
     std::vector<Ticket> result;
-    std::copy_if(current_data_->tickets.begin(), current_data_->tickets.end(),
-                std::back_inserter(result),
-                [sprint_id](const Ticket& t) { return t.sprint_id == sprint_id; });
+    for (int id : current_data_->search_index.search(query, limit))
+    {
+        result.push_back(current_data_->tickets[current_data_->ticket_slots.at(id)]);
+    }
+    return result;
+}
+
+std::vector<Ticket> DatabaseManager::searchTicketsSubstring(const std::string& fragment, size_t limit)
+{
+    TicketNeeds needs;
+    needs.trigram = true;
+    ReadLock lock = readTickets(needs);
+    std::vector<Ticket> result;
+    if (!current_data_)
+    {
+        return result;
+    }
+    
+    const ProjectData& data = *current_data_;
+    
+    const std::string folded = TrigramIndex::fold(fragment);
+    auto matches = [&folded](const Ticket& ticket)
+    {
+        return TrigramIndex::contains(ticket.title, folded) || TrigramIndex::contains(ticket.description, folded);
+    };
+    
+    std::vector<int> candidates;
+    if (data.trigram_index.substringCandidates(folded, candidates))
+    {
+        for (size_t i = 0; i < candidates.size() && result.size() < limit; ++i)
+        {
+            const Ticket& ticket = data.tickets[data.ticket_slots.at(candidates[i])];
+            if (matches(ticket))
+            {
+                result.push_back(ticket);
+            }
+        }
+        return result;
+    }
+    
+    // Too short to narrow: check every ticket
+    std::copy_if(data.tickets.begin(), data.tickets.end(), std::back_inserter(result), matches);
+    std::sort(result.begin(), result.end(), [](const Ticket& a, const Ticket& b) { return a.id < b.id; });
+    if (result.size() > limit)
+    {
+        result.resize(limit);
+    }
+    return result;
+}
+
+std::vector<Ticket> DatabaseManager::searchTicketsFuzzy(const std::string& fragment, int max_edits, size_t limit)
+{
+    TicketNeeds needs;
+    needs.trigram = true;
+    ReadLock lock = readTickets(needs);
+    std::vector<Ticket> result;
+    if (!current_data_)
+    {
+        return result;
+    }
+    
+    const ProjectData& data = *current_data_;
+    
+    const std::string folded = TrigramIndex::fold(fragment);
+    const FuzzyMatcher matcher(folded, max_edits);
+    std::vector<std::pair<int, size_t>> matches;    // (edits, slot)
+    auto check = [&](size_t slot)
+    {
+        const Ticket& ticket = data.tickets[slot];
+        int edits = std::min(matcher.distance(ticket.title), matcher.distance(ticket.description));
+        if (edits <= max_edits)
+        {
+            matches.emplace_back(edits, slot);
+        }
+    };
+    
+    std::vector<int> candidates;
+    if (data.trigram_index.fuzzyCandidates(folded, max_edits, candidates))
+    {
+        for (int id : candidates)
+        {
+            check(data.ticket_slots.at(id));
+        }
+    }
+    else
+    {
+        for (size_t slot = 0; slot < data.tickets.size(); ++slot)
+        {
+            check(slot);
+        }
+    }
     
+    std::sort(matches.begin(), matches.end(),
+              [&data](const auto& a, const auto& b)
+              {
+                  return a.first != b.first ? a.first < b.first
+                                            : data.tickets[a.second].id < data.tickets[b.second].id;
+              });
+    for (size_t i = 0; i < matches.size() && result.size() < limit; ++i)
+    {
+        result.push_back(data.tickets[matches[i].second]);
+    }
     return result;
 }
 
+const TicketColumns& DatabaseManager::getTicketColumns() const
+{
+    static const TicketColumns empty;
+    ReadLock lock = readTickets({});
+    return current_data_ ? current_data_->ticket_columns : empty;
+}
+
 bool DatabaseManager::updateTicket(const Ticket& ticket)
 {
+    WriteLock lock(*this);
     if (!current_data_)
     {
         return false;
     }
     
-    auto it = std::find_if(current_data_->tickets.begin(), current_data_->tickets.end(),
-                          [&ticket](const Ticket& t) { return t.id == ticket.id; });
+    materializeTickets(*current_data_);
+    Ticket* existing = findRecord(current_data_->tickets, current_data_->ticket_slots, ticket.id);
     
-    if (it != current_data_->tickets.end())
+    if (existing)
     {
-        Ticket old_ticket = *it;
-        *it = ticket;
-        it->updated_at = std::time(nullptr);
+        TicketStatus old_status = existing->status;
+        Ticket updated = ticket;
+        updated.updated_at = std::time(nullptr);
+        storeTicket(*current_data_, updated);
+        journalPut("ticket", updated, ChangeKind::Updated);
         
         // Log activity if status changed
-        if (old_ticket.status != ticket.status)
+        if (old_status != ticket.status)
         {
             Activity activity;
             activity.id = current_data_->next_activity_id++;
             activity.ticket_id = ticket.id;
             activity.action = "status_changed";
-            activity.description = "Changed ticket status from " + old_ticket.status + " to " + ticket.status;
+            activity.description = std::string("Changed ticket status from ") + toString(old_status) +
+                                   " to " + toString(ticket.status);
             activity.timestamp = std::time(nullptr);
-            current_data_->activities.push_back(activity);
+            recordActivity(activity);
         }
         
         return true;
@@ -425,18 +1767,20 @@ bool DatabaseManager::updateTicket(const Ticket& ticket)
 
 bool DatabaseManager::deleteTicket(int id)
 {
+    WriteLock lock(*this);
     if (!current_data_)
     {
         return false;
     }
     
-    auto it = std::find_if(current_data_->tickets.begin(), current_data_->tickets.end(),
-                          [id](const Ticket& t) { return t.id == id; });
+    materializeTickets(*current_data_);
+    Ticket* ticket = findRecord(current_data_->tickets, current_data_->ticket_slots, id);
     
-    if (it != current_data_->tickets.end())
+    if (ticket)
     {
-        std::string title = it->title;
-        current_data_->tickets.erase(it);
+        std::string title = ticket->title;
+        removeTicket(*current_data_, id);
+        journalErase("ticket", id);
         
         // Log activity
         Activity activity;
@@ -444,7 +1788,7 @@ bool DatabaseManager::deleteTicket(int id)
         activity.action = "ticket_deleted";
         activity.description = "Deleted ticket: " + title;
         activity.timestamp = std::time(nullptr);
-        current_data_->activities.push_back(activity);
+        recordActivity(activity);
         
         return true;
     }
@@ -455,13 +1799,15 @@ bool DatabaseManager::deleteTicket(int id)
 // Sprint operations
 bool DatabaseManager::createSprint(Sprint& sprint)
 {
+    WriteLock lock(*this);
     if (!current_data_)
     {
         return false;
     }
     
     sprint.id = current_data_->next_sprint_id++;
-    current_data_->sprints.push_back(sprint);
+    insertRecord(current_data_->sprints, current_data_->sprint_slots, sprint);
+    journalPut("sprint", sprint, ChangeKind::Created);
     
     // Log activity
     Activity activity;
@@ -469,42 +1815,49 @@ bool DatabaseManager::createSprint(Sprint& sprint)
     activity.action = "sprint_created";
     activity.description = "Created sprint: " + sprint.name;
     activity.timestamp = std::time(nullptr);
-    current_data_->activities.push_back(activity);
+    recordActivity(activity);
     
     return true;
 }
 
 Sprint DatabaseManager::getSprint(int id)
 {
+    ReadLock lock(*this);
     if (!current_data_)
     {
         return Sprint{};
     }
     
-    auto it = std::find_if(current_data_->sprints.begin(), current_data_->sprints.end(),
-                          [id](const Sprint& s) { return s.id == id; });
-    
-    return it != current_data_->sprints.end() ? *it : Sprint{};
+    Sprint* sprint = findRecord(current_data_->sprints, current_data_->sprint_slots, id);
+    return sprint ? *sprint : Sprint{};
 }
 
 std::vector<Sprint> DatabaseManager::getAllSprints()
 {
+    ReadLock lock = readRecords();
     return current_data_ ? current_data_->sprints : std::vector<Sprint>{};
 }
 
+RecordView<Sprint> DatabaseManager::getSprintsView() const
+{
+    ReadLock lock = readRecords();
+    return current_data_ ? RecordView<Sprint>(current_data_->sprints) : RecordView<Sprint>{};
+}
+
 bool DatabaseManager::updateSprint(const Sprint& sprint)
 {
+    WriteLock lock(*this);
     if (!current_data_)
     {
         return false;
     }
     
-    auto it = std::find_if(current_data_->sprints.begin(), current_data_->sprints.end(),
-                          [&sprint](const Sprint& s) { return s.id == sprint.id; });
+    Sprint* existing = findRecord(current_data_->sprints, current_data_->sprint_slots, sprint.id);
     
-    if (it != current_data_->sprints.end())
+    if (existing)
     {
-        *it = sprint;
+        *existing = sprint;
+        journalPut("sprint", *existing, ChangeKind::Updated);
         
         // Log activity
         Activity activity;
@@ -512,7 +1865,7 @@ bool DatabaseManager::updateSprint(const Sprint& sprint)
         activity.action = "sprint_updated";
         activity.description = "Updated sprint: " + sprint.name;
         activity.timestamp = std::time(nullptr);
-        current_data_->activities.push_back(activity);
+        recordActivity(activity);
         
         return true;
     }
@@ -522,18 +1875,19 @@ bool DatabaseManager::updateSprint(const Sprint& sprint)
 
 bool DatabaseManager::deleteSprint(int id)
 {
+    WriteLock lock(*this);
     if (!current_data_)
     {
         return false;
     }
     
-    auto it = std::find_if(current_data_->sprints.begin(), current_data_->sprints.end(),
-                          [id](const Sprint& s) { return s.id == id; });
+    Sprint* sprint = findRecord(current_data_->sprints, current_data_->sprint_slots, id);
     
-    if (it != current_data_->sprints.end())
+    if (sprint)
     {
-        std::string name = it->name;
-        current_data_->sprints.erase(it);
+        std::string name = sprint->name;
+        eraseRecord(current_data_->sprints, current_data_->sprint_slots, current_data_->erased_sprints, id);
+        journalErase("sprint", id);
         
         // Log activity
         Activity activity;
@@ -541,7 +1895,7 @@ bool DatabaseManager::deleteSprint(int id)
         activity.action = "sprint_deleted";
         activity.description = "Deleted sprint: " + name;
         activity.timestamp = std::time(nullptr);
-        current_data_->activities.push_back(activity);
+        recordActivity(activity);
         
         return true;
     }
@@ -552,6 +1906,7 @@ bool DatabaseManager::deleteSprint(int id)
 // Activity operations
 bool DatabaseManager::logActivity(const Activity& activity)
 {
+    WriteLock lock(*this);
     if (!current_data_)
     {
         return false;
@@ -560,35 +1915,107 @@ bool DatabaseManager::logActivity(const Activity& activity)
     Activity new_activity = activity;
     new_activity.id = current_data_->next_activity_id++;
     new_activity.timestamp = std::time(nullptr);
-    current_data_->activities.push_back(new_activity);
+    recordActivity(new_activity);
     
     return true;
 }
 
 std::vector<Activity> DatabaseManager::getRecentActivities(int limit)
 {
+    ReadLock lock(*this);
     if (!current_data_)
     {
         return std::vector<Activity>{};
     }
     
-    std::vector<Activity> result;
-    int start = std::max(0, static_cast<int>(current_data_->activities.size()) - limit);
+    ActivityView recent = getRecentActivitiesView(limit);
+    return std::vector<Activity>(recent.begin(), recent.end());
+}
+
+ActivityView DatabaseManager::getRecentActivitiesView(int limit) const
+{
+    ReadLock lock(*this);
+    if (!current_data_)
+    {
+        return ActivityView{};
+    }
     
-    for (size_t i = start; i < current_data_->activities.size(); ++i)
+    return current_data_->activities.recent(static_cast<size_t>(std::max(0, limit)));
+}
+
+ActivityView DatabaseManager::getActivitiesBetween(time_t from, time_t to) const
+{
+    ReadLock lock(*this);
+    return current_data_ ? current_data_->activities.between(from, to) : ActivityView{};
+}
+
+std::vector<Activity> DatabaseManager::getTicketActivities(int ticket_id, int limit)
+{
+    ReadLock lock(*this);
+    if (!current_data_)
     {
-        result.push_back(current_data_->activities[i]);
+        return std::vector<Activity>{};
     }
     
-    // Sort by timestamp (newest first)
-    std::sort(result.begin(), result.end(), 
-              [](const Activity& a, const Activity& b) { 
-                  return a.timestamp > b.timestamp; 
-              });
+    return current_data_->activities.forTicket(ticket_id, static_cast<size_t>(std::max(0, limit)));
+}
+
+std::vector<Activity> DatabaseManager::getActivityHistory(int before_id, int limit)
+{
+    ReadLock lock(*this);
+    std::vector<Activity> result;
+    if (!current_data_ || limit <= 0)
+    {
+        return result;
+    }
+    
+    // Entries still in memory first, walking back from before_id
+    const ActivityStore& activities = current_data_->activities;
+    for (size_t i = activities.lowerBound(before_id); i > 0 && result.size() < static_cast<size_t>(limit); --i)
+    {
+        result.push_back(activities[i - 1]);
+    }
+    if (!activities.empty())
+    {
+        before_id = std::min(before_id, activities[0].id);
+    }
     
+    // Then archived batches, newest first, reading only as many as needed
+    std::string directory = getArchiveDirectory(current_project_);
+    std::vector<int> batches = ActivityArchive::listBatches(directory);
+    for (auto it = batches.rbegin(); it != batches.rend() && result.size() < static_cast<size_t>(limit); ++it)
+    {
+        if (*it >= before_id)
+        {
+            continue;
+        }
+        
+        std::vector<Activity> batch;
+        if (!ActivityArchive::loadBatch(directory, *it, batch))
+        {
+            break;
+        }
+        for (auto entry = batch.rbegin(); entry != batch.rend() && result.size() < static_cast<size_t>(limit); ++entry)
+        {
+            if (entry->id < before_id)
+            {
+                result.push_back(std::move(*entry));
+            }
+        }
+    }
     return result;
 }
 
+void DatabaseManager::setActivityRingCapacity(size_t entries)
+{
+    WriteLock lock(*this);
+    activity_capacity_ = std::max<size_t>(entries, 1);
+    for (auto& project : projects_)
+    {
+        project.second.activities.setCapacity(activity_capacity_);
+    }
+}
+
 std::vector<std::string> DatabaseManager::getAvailableProjects()
 {
     std::vector<std::string> projects;
@@ -599,13 +2026,18 @@ std::vector<std::string> DatabaseManager::getAvailableProjects()
         return projects;
     }
     
-    // Scan project directory for JSON files
+    // Scan project directory for JSON, binary and segmented snapshots
     for (const auto& entry : std::filesystem::directory_iterator("projects"))
     {
-        if (entry.is_regular_file() && entry.path().extension() == ".json")
+        auto extension = entry.path().extension();
+        if ((entry.is_regular_file() && (extension == ".json" || extension == ".rsp")) ||
+            (entry.is_directory() && extension == ".rsd"))
         {
             std::string project_name = entry.path().stem().string();
-            projects.push_back(project_name);
+            if (std::find(projects.begin(), projects.end(), project_name) == projects.end())
+            {
+                projects.push_back(project_name);
+            }
         }
     }
     
@@ -614,6 +2046,7 @@ std::vector<std::string> DatabaseManager::getAvailableProjects()
 
 std::string DatabaseManager::getCurrentProjectName() const
 {
+    ReadLock lock(*this);
     return current_project_;
 }
 
@@ -629,9 +2062,44 @@ bool DatabaseManager::createTables()
     return true;
 }
 
-std::string DatabaseManager::getProjectFilePath(const std::string& project_name)
+std::string DatabaseManager::getProjectFilePath(const std::string& project_name) const
+{
+    // Prefer segmented, then binary, when more than one snapshot exists
+    for (SnapshotFormat format : { SnapshotFormat::Segmented, SnapshotFormat::Binary })
+    {
+        std::string path = getProjectFilePath(project_name, format);
+        if (std::filesystem::exists(path))
+        {
+            return path;
+        }
+    }
+    return getProjectFilePath(project_name, SnapshotFormat::Json);
+}
+
+std::string DatabaseManager::getProjectFilePath(const std::string& project_name, SnapshotFormat format) const
+{
+    switch (format)
+    {
+    case SnapshotFormat::Binary:    return "projects/" + project_name + ".rsp";
+    case SnapshotFormat::Segmented: return "projects/" + project_name + ".rsd";
+    default:                        return "projects/" + project_name + ".json";
+    }
+}
+
+std::string DatabaseManager::getArchiveDirectory(const std::string& project_name)
+{
+    return "projects/" + project_name + ".archive";
+}
+
+std::string DatabaseManager::getJournalFilePath(const std::string& project_name) const
 {
-    return "projects/" + project_name + ".json";
+    return "projects/" + project_name + ".journal";
+}
+
+void DatabaseManager::setJournalCompactionThreshold(size_t records)
+{
+    WriteLock lock(*this);
+    journal_compaction_threshold_ = std::max<size_t>(records, 1);
 }
 
 void DatabaseManager::clearInMemoryData()
@@ -641,8 +2109,23 @@ void DatabaseManager::clearInMemoryData()
     {
         current_data_->users.clear();
         current_data_->tickets.clear();
+        current_data_->ticket_columns.clear();
+        current_data_->search_index.clear();
+        current_data_->trigram_index.clear();
+        current_data_->order_index.clear();
+        current_data_->tables.clear();
+        current_data_->lazy_tickets.reset();
         current_data_->sprints.clear();
         current_data_->activities.clear();
+        current_data_->user_slots.clear();
+        current_data_->ticket_slots.clear();
+        current_data_->sprint_slots.clear();
+        current_data_->erased_users = 0;
+        current_data_->erased_tickets = 0;
+        current_data_->erased_sprints = 0;
+        current_data_->tickets_by_sprint.clear();
+        current_data_->tickets_by_assignee.clear();
+        current_data_->tickets_by_status.clear();
         current_data_->next_user_id = 1;
         current_data_->next_ticket_id = 1;
         current_data_->next_sprint_id = 1;
@@ -655,15 +2138,6 @@ void DatabaseManager::loadInMemoryData()
     // This is handled by loadProject now
 }
 
-// Auto-save on destruction
-DatabaseManager::~DatabaseManager()
-{
-    if (!current_project_.empty())
-    {
-        saveProject(current_project_);
-    }
-}
-
 // Auto-save on destruction
 DatabaseManager::~DatabaseManager()
 {
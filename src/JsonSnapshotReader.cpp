@@ -0,0 +1,334 @@
+#include "JsonSnapshotReader.hpp"
+#include <algorithm>
+#include <cstdint>
+
+#include "../external/nlohmann/json/single_include/nlohmann/json.hpp"
+
+namespace
+{
+    using json = nlohmann::json;
+
+    // Integer fields, by record type. Unknown keys are skipped so newer
+    // snapshots still load.
+    bool setInteger(User& u, const std::string& key, int64_t value)
+    {
+        if (key == "id") u.id = static_cast<int>(value);
+        else if (key == "created_at") u.created_at = static_cast<time_t>(value);
+        else return key != "username" && key != "password" && key != "role";
+        return true;
+    }
+
+    bool setInteger(Ticket& t, const std::string& key, int64_t value)
+    {
+        if (key == "id") t.id = static_cast<int>(value);
+        else if (key == "assignee_id") t.assignee_id = static_cast<int>(value);
+        else if (key == "sprint_id") t.sprint_id = static_cast<int>(value);
+        else if (key == "story_points") t.story_points = static_cast<int>(value);
+        else if (key == "created_at") t.created_at = static_cast<time_t>(value);
+        else if (key == "updated_at") t.updated_at = static_cast<time_t>(value);
+        else return key != "title" && key != "description" && key != "status" &&
+                    key != "priority" && key != "type";
+        return true;
+    }
+
+    bool setInteger(Sprint& s, const std::string& key, int64_t value)
+    {
+        if (key == "id") s.id = static_cast<int>(value);
+        else if (key == "start_date") s.start_date = static_cast<time_t>(value);
+        else if (key == "end_date") s.end_date = static_cast<time_t>(value);
+        else return key != "name" && key != "goal" && key != "status";
+        return true;
+    }
+
+    bool setInteger(Activity& a, const std::string& key, int64_t value)
+    {
+        if (key == "id") a.id = static_cast<int>(value);
+        else if (key == "ticket_id") a.ticket_id = static_cast<int>(value);
+        else if (key == "user_id") a.user_id = static_cast<int>(value);
+        else if (key == "timestamp") a.timestamp = static_cast<time_t>(value);
+        else return key != "action" && key != "description";
+        return true;
+    }
+
+    // String fields, by record type; the value is moved in, never copied
+    bool setString(User& u, const std::string& key, std::string& value)
+    {
+        if (key == "username") u.username = std::move(value);
+        else if (key == "password") u.password = std::move(value);
+        else if (key == "role") u.role = std::move(value);
+        else return key != "id" && key != "created_at";
+        return true;
+    }
+
+    bool setString(Ticket& t, const std::string& key, std::string& value)
+    {
+        if (key == "title") t.title = std::move(value);
+        else if (key == "description") t.description = std::move(value);
+        else if (key == "status") parseTicketStatus(value, t.status);
+        else if (key == "priority") parseTicketPriority(value, t.priority);
+        else if (key == "type") parseTicketType(value, t.type);
+        else return key != "id" && key != "assignee_id" && key != "sprint_id" &&
+                    key != "story_points" && key != "created_at" && key != "updated_at";
+        return true;
+    }
+
+    bool setString(Sprint& s, const std::string& key, std::string& value)
+    {
+        if (key == "name") s.name = std::move(value);
+        else if (key == "goal") s.goal = std::move(value);
+        else if (key == "status") s.status = std::move(value);
+        else return key != "id" && key != "start_date" && key != "end_date";
+        return true;
+    }
+
+    bool setString(Activity& a, const std::string& key, std::string& value)
+    {
+        if (key == "action") a.action = std::move(value);
+        else if (key == "description") a.description = std::move(value);
+        else return key != "id" && key != "ticket_id" && key != "user_id" && key != "timestamp";
+        return true;
+    }
+
+    // Nesting: the root object is depth 1, the section arrays (and the
+    // next_ids object) depth 2, records depth 3. Anything deeper belongs
+    // to a field this reader does not know and is skipped.
+    class ProjectSaxHandler : public nlohmann::json_sax<json>
+    {
+    public:
+        enum Section { None, Users, Tickets, Sprints, Activities, NextIds, Unknown };
+
+        // input_bytes is the size of the whole snapshot, or 0 if unknown
+        ProjectSaxHandler(ProjectData& data, size_t input_bytes) : data_(data), input_bytes_(input_bytes) {}
+
+        bool null() override { return true; }
+        bool boolean(bool) override { return true; }
+        bool number_integer(number_integer_t value) override { return integer(value); }
+        bool number_unsigned(number_unsigned_t value) override { return integer(static_cast<int64_t>(value)); }
+        bool number_float(number_float_t value, const string_t&) override { return integer(static_cast<int64_t>(value)); }
+        bool binary(binary_t&) override { return true; }
+
+        bool string(string_t& value) override
+        {
+            if (depth_ != 3)
+            {
+                return true;
+            }
+            switch (section_)
+            {
+            case Users:      return setString(user_, key_, value) || fieldError();
+            case Tickets:    return setString(ticket_, key_, value) || fieldError();
+            case Sprints:    return setString(sprint_, key_, value) || fieldError();
+            case Activities: return setString(activity_, key_, value) || fieldError();
+            default:         return true;
+            }
+        }
+
+        bool start_object(std::size_t) override
+        {
+            ++depth_;
+            if (depth_ == 3)
+            {
+                switch (section_)
+                {
+                case Users:      user_ = User(); break;
+                case Tickets:    ticket_ = Ticket(); break;
+                case Sprints:    sprint_ = Sprint(); break;
+                case Activities: activity_ = Activity(); break;
+                default:         break;
+                }
+            }
+            return true;
+        }
+
+        bool end_object() override
+        {
+            if (depth_ == 3)
+            {
+                switch (section_)
+                {
+                case Users:      data_.users.push_back(std::move(user_)); break;
+                case Tickets:    data_.tickets.push_back(std::move(ticket_)); break;
+                case Sprints:    data_.sprints.push_back(std::move(sprint_)); break;
+                case Activities: data_.activities.push_back(std::move(activity_)); break;
+                default:         break;
+                }
+            }
+            if (depth_ == 2)
+            {
+                if (section_ == NextIds)
+                {
+                    reserveRecords();
+                }
+                section_ = None;
+            }
+            --depth_;
+            return true;
+        }
+
+        bool start_array(std::size_t) override
+        {
+            ++depth_;
+            return true;
+        }
+
+        bool end_array() override
+        {
+            if (depth_ == 2)
+            {
+                section_ = None;
+            }
+            --depth_;
+            return true;
+        }
+
+        bool key(string_t& value) override
+        {
+            if (depth_ == 1)
+            {
+                section_ = value == "users"      ? Users
+                         : value == "tickets"    ? Tickets
+                         : value == "sprints"    ? Sprints
+                         : value == "activities" ? Activities
+                         : value == "next_ids"   ? NextIds
+                         : Unknown;
+                seen_ |= 1u << section_;
+            }
+            else
+            {
+                key_ = std::move(value);
+            }
+            return true;
+        }
+
+        bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& ex) override
+        {
+            error_ = ex.what();
+            error_ += " (byte " + std::to_string(position) + ")";
+            return false;
+        }
+
+        bool complete() const
+        {
+            const unsigned required = (1u << Users) | (1u << Tickets) | (1u << Sprints) |
+                                      (1u << Activities) | (1u << NextIds);
+            return (seen_ & required) == required;
+        }
+
+        const std::string& error() const { return error_; }
+
+    private:
+        // Smallest a record can be in the file, every field being written
+        static constexpr size_t kMinUserBytes = 48;
+        static constexpr size_t kMinTicketBytes = 128;
+        static constexpr size_t kMinSprintBytes = 56;
+
+        // Snapshots are written with sorted keys, so next_ids comes ahead of
+        // the users, sprints and tickets. Each counter bounds how many
+        // records its section holds; the input size bounds it again when
+        // many ids have been deleted or the counters were edited by hand.
+        void reserveRecords()
+        {
+            if (input_bytes_ == 0)
+            {
+                return;
+            }
+            auto bound = [this](int next_id, size_t min_record_bytes)
+            {
+                size_t by_ids = next_id > 1 ? static_cast<size_t>(next_id - 1) : 0;
+                return std::min(by_ids, input_bytes_ / min_record_bytes);
+            };
+            data_.users.reserve(bound(data_.next_user_id, kMinUserBytes));
+            data_.tickets.reserve(bound(data_.next_ticket_id, kMinTicketBytes));
+            data_.sprints.reserve(bound(data_.next_sprint_id, kMinSprintBytes));
+        }
+
+        bool integer(int64_t value)
+        {
+            if (depth_ == 2 && section_ == NextIds)
+            {
+                if (key_ == "user") data_.next_user_id = static_cast<int>(value);
+                else if (key_ == "ticket") data_.next_ticket_id = static_cast<int>(value);
+                else if (key_ == "sprint") data_.next_sprint_id = static_cast<int>(value);
+                else if (key_ == "activity") data_.next_activity_id = static_cast<int>(value);
+                return true;
+            }
+            if (depth_ != 3)
+            {
+                return true;
+            }
+            switch (section_)
+            {
+            case Users:      return setInteger(user_, key_, value) || fieldError();
+            case Tickets:    return setInteger(ticket_, key_, value) || fieldError();
+            case Sprints:    return setInteger(sprint_, key_, value) || fieldError();
+            case Activities: return setInteger(activity_, key_, value) || fieldError();
+            default:         return true;
+            }
+        }
+
+        bool fieldError()
+        {
+            error_ = "field '" + key_ + "' has the wrong type";
+            return false;
+        }
+
+        ProjectData& data_;
+        const size_t input_bytes_;
+        Section section_ = None;
+        unsigned seen_ = 0;
+        int depth_ = 0;
+        std::string key_;
+        std::string error_;
+
+        User user_;
+        Ticket ticket_;
+        Sprint sprint_;
+        Activity activity_;
+    };
+}
+
+bool JsonSnapshotReader::read(std::istream& in, ProjectData& data, std::string& error)
+{
+    // The remaining size, when the stream can tell, caps the reservations
+    size_t input_bytes = 0;
+    std::istream::pos_type start = in.tellg();
+    if (start != std::istream::pos_type(-1) && in.seekg(0, std::ios::end))
+    {
+        input_bytes = static_cast<size_t>(in.tellg() - start);
+        in.seekg(start);
+    }
+    in.clear();
+
+    ProjectSaxHandler handler(data, input_bytes);
+    if (!json::sax_parse(in, &handler))
+    {
+        error = handler.error();
+        return false;
+    }
+    if (!handler.complete())
+    {
+        error = "snapshot is missing a section";
+        return false;
+    }
+
+    // Counters from an older or hand-edited file must never hand out an id
+    // that is already taken
+    for (const auto& user : data.users)
+    {
+        data.next_user_id = std::max(data.next_user_id, user.id + 1);
+    }
+    for (const auto& ticket : data.tickets)
+    {
+        data.next_ticket_id = std::max(data.next_ticket_id, ticket.id + 1);
+    }
+    for (const auto& sprint : data.sprints)
+    {
+        data.next_sprint_id = std::max(data.next_sprint_id, sprint.id + 1);
+    }
+    for (const auto& activity : data.activities)
+    {
+        data.next_activity_id = std::max(data.next_activity_id, activity.id + 1);
+    }
+    data.format = SnapshotFormat::Json;
+    return true;
+}
@@ -0,0 +1,60 @@
+#include "LoadWorker.hpp"
+#include <exception>
+#include <iostream>
+
+LoadWorker::LoadWorker()
+    : thread_([this] { run(); })
+{
+}
+
+LoadWorker::~LoadWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        jobs_.clear();
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+void LoadWorker::post(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    wake_.notify_one();
+}
+
+void LoadWorker::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        wake_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (stopping_)
+        {
+            return;
+        }
+
+        std::function<void()> job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+        // Jobs handle their own errors; anything that escapes one must not
+        // take the thread down with it
+        try
+        {
+            job();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Background load failed: " << e.what() << std::endl;
+        }
+        catch (...)
+        {
+            std::cerr << "Background load failed" << std::endl;
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,219 @@
+//ProjectJournal.cpp
+#include "ProjectJournal.hpp"
+#include "AtomicFile.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+bool ProjectJournal::open(const std::string& path)
+{
+    close();
+    path_ = path;
+    record_count_ = 0;
+
+    // Count what an earlier session left behind so compaction still
+    // triggers at the right size.
+    std::ifstream existing(path_);
+    std::string line;
+    while (std::getline(existing, line))
+    {
+        if (!line.empty())
+        {
+            ++record_count_;
+        }
+    }
+
+    return openFile(false);
+}
+
+bool ProjectJournal::append(const nlohmann::json& record)
+{
+    if (!isOpen())
+    {
+        return false;
+    }
+
+    const bool written = writeSynced(record.dump() + '\n');
+    ++record_count_;
+    return written;
+}
+
+#ifdef _WIN32
+
+bool ProjectJournal::isOpen() const
+{
+    return file_ != nullptr;
+}
+
+bool ProjectJournal::openFile(bool truncate)
+{
+    HANDLE file = CreateFileA(path_.c_str(), truncate ? GENERIC_WRITE : FILE_APPEND_DATA,
+                              FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    file_ = file != INVALID_HANDLE_VALUE ? file : nullptr;
+    return file_ != nullptr;
+}
+
+void ProjectJournal::close()
+{
+    if (file_)
+    {
+        CloseHandle(file_);
+        file_ = nullptr;
+    }
+}
+
+bool ProjectJournal::writeSynced(const std::string& bytes)
+{
+    size_t written = 0;
+    bool ok = true;
+    while (ok && written < bytes.size())
+    {
+        DWORD done = 0;
+        ok = WriteFile(file_, bytes.data() + written, static_cast<DWORD>(bytes.size() - written), &done, nullptr) &&
+             done > 0;
+        written += done;
+    }
+    return ok && FlushFileBuffers(file_);
+}
+
+#else
+
+bool ProjectJournal::isOpen() const
+{
+    return fd_ >= 0;
+}
+
+bool ProjectJournal::openFile(bool truncate)
+{
+    fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0644);
+    if (fd_ < 0)
+    {
+        return false;
+    }
+    // The file may be new; its directory entry has to last as long as
+    // the records synced into it
+    AtomicFile::syncDirectory(path_);
+    return true;
+}
+
+void ProjectJournal::close()
+{
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool ProjectJournal::writeSynced(const std::string& bytes)
+{
+    size_t written = 0;
+    bool ok = true;
+    while (ok && written < bytes.size())
+    {
+        ssize_t done = ::write(fd_, bytes.data() + written, bytes.size() - written);
+        if (done < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        ok = done > 0;
+        written += ok ? static_cast<size_t>(done) : 0;
+    }
+    return ok && fsync(fd_) == 0;
+}
+
+#endif
+
+bool ProjectJournal::rotate(const std::string& rotated_path)
+{
+    if (path_.empty())
+    {
+        return false;
+    }
+
+    close();
+    std::error_code error;
+    if (std::filesystem::exists(path_, error))
+    {
+        std::filesystem::rename(path_, rotated_path, error);
+    }
+    record_count_ = 0;
+    return openFile(true) && !error;
+}
+
+std::string ProjectJournal::rotatedPath(const std::string& path, uint64_t generation)
+{
+    return path + "." + std::to_string(generation);
+}
+
+std::vector<std::pair<uint64_t, std::string>> ProjectJournal::rotatedLogs(const std::string& path)
+{
+    std::vector<std::pair<uint64_t, std::string>> logs;
+    std::filesystem::path journal(path);
+    std::filesystem::path directory = journal.has_parent_path() ? journal.parent_path() : ".";
+    std::string prefix = journal.filename().string() + ".";
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+
+        std::string suffix = name.substr(prefix.size());
+        if (!std::all_of(suffix.begin(), suffix.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        {
+            continue;
+        }
+        logs.emplace_back(std::stoull(suffix), entry.path().string());
+    }
+
+    std::sort(logs.begin(), logs.end());
+    return logs;
+}
+
+size_t ProjectJournal::replay(const std::string& path,
+                              const std::function<void(const nlohmann::json&)>& apply)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return 0;
+    }
+
+    size_t applied = 0;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        nlohmann::json record = nlohmann::json::parse(line, nullptr, false);
+        if (record.is_discarded())
+        {
+            std::cerr << "Ignoring torn journal record in " << path << std::endl;
+            break;
+        }
+
+        apply(record);
+        ++applied;
+    }
+    return applied;
+}
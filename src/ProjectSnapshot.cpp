@@ -0,0 +1,73 @@
+#include "ProjectSnapshot.hpp"
+#include "ProjectData.hpp"
+#include <vector>
+
+namespace
+{
+    const ProjectTables& emptyTables()
+    {
+        static const ProjectTables empty;
+        return empty;
+    }
+
+    template <typename Record>
+    std::vector<Record> toVector(const PersistentTable<Record>& table)
+    {
+        std::vector<Record> records;
+        records.reserve(table.size());
+        table.forEach([&records](const Record& record)
+        {
+            records.push_back(record);
+            return true;
+        });
+        return records;
+    }
+}
+
+const std::string& ProjectSnapshot::projectName() const
+{
+    static const std::string none;
+    return state_ ? state_->project_name : none;
+}
+
+uint64_t ProjectSnapshot::version(ChangeEntity entity) const
+{
+    return state_ ? state_->versions[static_cast<size_t>(entity)] : 0;
+}
+
+const PersistentTable<User>& ProjectSnapshot::users() const
+{
+    return (state_ ? state_->tables : emptyTables()).users;
+}
+
+const PersistentTable<Ticket>& ProjectSnapshot::tickets() const
+{
+    return (state_ ? state_->tables : emptyTables()).tickets;
+}
+
+const PersistentTable<Sprint>& ProjectSnapshot::sprints() const
+{
+    return (state_ ? state_->tables : emptyTables()).sprints;
+}
+
+const PersistentTable<Activity>& ProjectSnapshot::activities() const
+{
+    return (state_ ? state_->tables : emptyTables()).activities;
+}
+
+void ProjectSnapshot::copyTo(ProjectData& data) const
+{
+    if (!state_)
+    {
+        return;
+    }
+    
+    data.users = toVector(state_->tables.users);
+    data.tickets = toVector(state_->tables.tickets);
+    data.sprints = toVector(state_->tables.sprints);
+    data.activities.assign(toVector(state_->tables.activities));
+    data.next_user_id = state_->next_user_id;
+    data.next_ticket_id = state_->next_ticket_id;
+    data.next_sprint_id = state_->next_sprint_id;
+    data.next_activity_id = state_->next_activity_id;
+}
@@ -0,0 +1,74 @@
+#include "SaveWorker.hpp"
+#include <algorithm>
+
+SaveWorker::SaveWorker()
+    : thread_([this] { run(); })
+{
+}
+
+SaveWorker::~SaveWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+std::future<bool> SaveWorker::post(std::function<bool()> job)
+{
+    Job entry{ std::move(job), std::promise<bool>() };
+    std::future<bool> result = entry.done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(entry));
+    }
+    wake_.notify_one();
+    return result;
+}
+
+SaveStats SaveWorker::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void SaveWorker::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        // Pending saves are still written on shutdown; dropping them would
+        // lose edits whose journal has already been rotated away
+        wake_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (jobs_.empty())
+        {
+            return;
+        }
+
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+
+        auto started = std::chrono::steady_clock::now();
+        bool ok = false;
+        try
+        {
+            ok = job.write();
+        }
+        catch (...)
+        {
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started);
+
+        lock.lock();
+        ++stats_.saves;
+        stats_.failures += ok ? 0 : 1;
+        stats_.last_latency = elapsed;
+        stats_.max_latency = std::max(stats_.max_latency, elapsed);
+        stats_.total_latency += elapsed;
+        job.done.set_value(ok);
+    }
+}
@@ -5,6 +5,7 @@
 #include "models.hpp"
 #include "ScrumJiraApp.hpp"
 #include <iostream>
+#include <algorithm>
 
 ScrumJiraApp::ScrumJiraApp() : running_(false) {}
 
@@ -182,10 +183,14 @@ void ScrumJiraApp::createNewTicket()
     ticket.description = ui_->getInput(200);
     
     ui_->printAt(5, 10, "Type (Bug/Feature/Task): ");
-    ticket.type = ui_->getInput(20);
+    std::string type = ui_->getInput(20);
+    std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+    parseTicketType(type, ticket.type);
     
     ui_->printAt(5, 12, "Priority (Low/Medium/High): ");
-    ticket.priority = ui_->getInput(10);
+    std::string priority = ui_->getInput(10);
+    std::transform(priority.begin(), priority.end(), priority.begin(), ::tolower);
+    parseTicketPriority(priority, ticket.priority);
     
     if (db_->createTicket(ticket))
     {
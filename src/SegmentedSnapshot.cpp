@@ -0,0 +1,197 @@
+#include "SegmentedSnapshot.hpp"
+#include "AtomicFile.hpp"
+#include "BinarySnapshot.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <unordered_set>
+
+namespace
+{
+    const char kMetaSegment[] = "meta.rsp";
+    const char kTicketPrefix[] = "tickets-";
+    const char kActivityPrefix[] = "activities-";
+    const char kSegmentExtension[] = ".rsp";
+
+    std::string segmentName(const std::string& prefix, int segment)
+    {
+        return prefix + std::to_string(segment) + kSegmentExtension;
+    }
+
+    bool isSegmentFile(const std::string& name, const std::string& prefix)
+    {
+        const std::string extension = kSegmentExtension;
+        return name.size() > prefix.size() + extension.size() &&
+               name.compare(0, prefix.size(), prefix) == 0 &&
+               name.compare(name.size() - extension.size(), extension.size(), extension) == 0;
+    }
+
+    // Groups the records of the requested segments, encodes each group, and
+    // adds an empty entry for requested segments that no longer hold anything
+    template <typename Records, typename SegmentOf, typename Slice>
+    void encodeSegments(const Records& records, bool all, const std::set<int>& dirty,
+                        const std::string& prefix, SegmentOf segment_of, Slice slice,
+                        std::vector<SnapshotSegment>& out)
+    {
+        std::map<int, ProjectData> groups;
+        for (const auto& record : records)
+        {
+            int segment = segment_of(record.id);
+            if (all || dirty.count(segment) > 0)
+            {
+                slice(groups[segment]).push_back(record);
+            }
+        }
+
+        for (const auto& group : groups)
+        {
+            out.push_back({ segmentName(prefix, group.first), BinarySnapshot::encode(group.second) });
+        }
+        for (int segment : dirty)
+        {
+            if (groups.count(segment) == 0)
+            {
+                out.push_back({ segmentName(prefix, segment), std::string() });
+            }
+        }
+    }
+}
+
+std::vector<SnapshotSegment> SegmentedSnapshot::encode(const ProjectData& data, const DirtySegments& dirty)
+{
+    std::vector<SnapshotSegment> segments;
+    if (dirty.empty())
+    {
+        return segments;
+    }
+
+    ProjectData meta;
+    meta.users = data.users;
+    meta.sprints = data.sprints;
+    meta.next_user_id = data.next_user_id;
+    meta.next_ticket_id = data.next_ticket_id;
+    meta.next_sprint_id = data.next_sprint_id;
+    meta.next_activity_id = data.next_activity_id;
+    segments.push_back({ kMetaSegment, BinarySnapshot::encode(meta) });
+
+    encodeSegments(data.tickets, dirty.all, dirty.tickets, kTicketPrefix,
+                   &DirtySegments::ticketSegment,
+                   [](ProjectData& slice) -> std::vector<Ticket>& { return slice.tickets; },
+                   segments);
+    encodeSegments(data.activities, dirty.all, dirty.activities, kActivityPrefix,
+                   &DirtySegments::activitySegment,
+                   [](ProjectData& slice) -> ActivityStore& { return slice.activities; },
+                   segments);
+    return segments;
+}
+
+bool SegmentedSnapshot::write(const std::string& directory, const std::vector<SnapshotSegment>& segments,
+                              bool replace_all)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        return false;
+    }
+
+    // Meta goes last: a crash part-way leaves the old counters, and load
+    // raises them past whatever the newer segments hold
+    std::unordered_set<std::string> written;
+    const SnapshotSegment* meta = nullptr;
+    for (const auto& segment : segments)
+    {
+        written.insert(segment.name);
+        std::string path = directory + "/" + segment.name;
+        if (segment.name == kMetaSegment)
+        {
+            meta = &segment;
+        }
+        else if (segment.bytes.empty())
+        {
+            std::filesystem::remove(path, error);
+        }
+        else if (!AtomicFile::write(path, segment.bytes))
+        {
+            return false;
+        }
+    }
+
+    if (replace_all)
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+        {
+            std::string name = entry.path().filename().string();
+            if ((isSegmentFile(name, kTicketPrefix) || isSegmentFile(name, kActivityPrefix)) &&
+                written.count(name) == 0)
+            {
+                std::filesystem::remove(entry.path(), error);
+            }
+        }
+    }
+
+    return !meta || AtomicFile::write(directory + "/" + meta->name, meta->bytes);
+}
+
+bool SegmentedSnapshot::load(const std::string& directory, ProjectData& data)
+{
+    if (!BinarySnapshot::load(directory + "/" + kMetaSegment, data))
+    {
+        return false;
+    }
+
+    std::vector<Activity> activities;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        std::string name = entry.path().filename().string();
+        bool tickets = isSegmentFile(name, kTicketPrefix);
+        if (!tickets && !isSegmentFile(name, kActivityPrefix))
+        {
+            continue;
+        }
+
+        ProjectData slice;
+        if (!BinarySnapshot::load(entry.path().string(), slice))
+        {
+            return false;
+        }
+
+        if (tickets)
+        {
+            data.tickets.insert(data.tickets.end(),
+                                std::make_move_iterator(slice.tickets.begin()),
+                                std::make_move_iterator(slice.tickets.end()));
+        }
+        else
+        {
+            activities.insert(activities.end(), slice.activities.begin(), slice.activities.end());
+        }
+    }
+    if (error)
+    {
+        return false;
+    }
+
+    // Segments are visited in directory order, which need not be numeric;
+    // tickets are listed and the activity log is read in id order
+    std::sort(data.tickets.begin(), data.tickets.end(),
+              [](const Ticket& a, const Ticket& b) { return a.id < b.id; });
+    std::sort(activities.begin(), activities.end(),
+              [](const Activity& a, const Activity& b) { return a.id < b.id; });
+
+    for (const auto& ticket : data.tickets)
+    {
+        data.next_ticket_id = std::max(data.next_ticket_id, ticket.id + 1);
+    }
+    if (!activities.empty())
+    {
+        data.next_activity_id = std::max(data.next_activity_id, activities.back().id + 1);
+    }
+    data.activities.assign(std::move(activities));
+
+    data.format = SnapshotFormat::Segmented;
+    data.dirty = DirtySegments{};
+    data.dirty.all = false;
+    return true;
+}
@@ -1,5 +1,4 @@
 //SprintManager.cpp
-#include "UIManager.hpp"
 #include "DatabaseManager.hpp"
 #include "TicketManager.hpp"
 #include "SprintManager.hpp"
@@ -33,7 +32,7 @@ std::vector<Sprint> SprintManager::getAllSprints()
 
 Sprint SprintManager::getActiveSprint()
 {
-	auto sprints = DatabaseManager::getInstance().getAllSprints();
+	auto sprints = DatabaseManager::getInstance().getSprintsView();
 
 	auto it = std::find_if(sprints.begin(), sprints.end(),
 				     [](const Sprint &sprint)
@@ -56,7 +55,7 @@ bool SprintManager::deleteSprint(int id)
 
 std::vector<Sprint> SprintManager::getSprintsByStatus(const std::string &status)
 {
-	auto all_sprints = DatabaseManager::getInstance().getAllSprints();
+	auto all_sprints = DatabaseManager::getInstance().getSprintsView();
 	std::vector<Sprint> results;
 
 	std::copy_if(all_sprints.begin(), all_sprints.end(),
@@ -79,6 +78,11 @@ bool SprintManager::startSprint(int sprint_id)
 	return DatabaseManager::getInstance().updateSprint(sprint);
 }
 
+SprintStats SprintManager::getSprintStats(int sprint_id)
+{
+	return SprintStatsEngine::compute(DatabaseManager::getInstance().getTicketColumns(), sprint_id);
+}
+
 bool SprintManager::completeSprint(int sprint_id)
 {
 	Sprint sprint = DatabaseManager::getInstance().getSprint(sprint_id);
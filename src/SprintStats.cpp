@@ -0,0 +1,272 @@
+#include "SprintStats.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+// The AVX2 kernel is built with a per-function target attribute, so the
+// rest of the program keeps the baseline instruction set and the kernel is
+// only entered after a runtime CPU check
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SPRINT_STATS_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Per-assignee totals. User ids are small and dense, so they index a
+    // flat table; anything else goes to a map.
+    class LoadMap
+    {
+    public:
+        void add(int assignee_id, TicketStatus status, int points)
+        {
+            AssigneeLoad& entry = at(assignee_id);
+            entry.assignee_id = assignee_id;
+            ++entry.tickets;
+            entry.open_points += status != TicketStatus::Done ? points : 0;
+        }
+
+        void collect(std::vector<AssigneeLoad>& out) const
+        {
+            for (const auto& entry : dense_)
+            {
+                if (entry.tickets > 0)
+                {
+                    out.push_back(entry);
+                }
+            }
+            for (const auto& entry : sparse_)
+            {
+                out.push_back(entry.second);
+            }
+        }
+
+    private:
+        static constexpr int kDenseIds = 1 << 16;
+
+        AssigneeLoad& at(int assignee_id)
+        {
+            if (assignee_id < 0 || assignee_id >= kDenseIds)
+            {
+                return sparse_[assignee_id];
+            }
+            if (static_cast<size_t>(assignee_id) >= dense_.size())
+            {
+                dense_.resize(static_cast<size_t>(assignee_id) + 1);
+            }
+            return dense_[assignee_id];
+        }
+
+        std::vector<AssigneeLoad> dense_;
+        std::unordered_map<int, AssigneeLoad> sparse_;
+    };
+
+    void finish(SprintStats& stats, const LoadMap& load)
+    {
+        stats.tickets = 0;
+        for (size_t count : stats.status_counts)
+        {
+            stats.tickets += count;
+        }
+
+        load.collect(stats.assignee_load);
+        std::sort(stats.assignee_load.begin(), stats.assignee_load.end(),
+                  [](const AssigneeLoad& a, const AssigneeLoad& b)
+                  {
+                      return a.open_points != b.open_points ? a.open_points > b.open_points
+                                                            : a.assignee_id < b.assignee_id;
+                  });
+    }
+
+    // Slots [first, last) one at a time; the whole scan for the scalar
+    // kernel and the tail for the vector one
+    void accumulate(const TicketColumns& columns, int sprint_id, size_t first, size_t last,
+                    SprintStats& stats, LoadMap& load)
+    {
+        const int* sprints = columns.sprintIds().begin();
+        const int* points = columns.storyPoints().begin();
+        const TicketStatus* statuses = columns.statuses().begin();
+        const int* assignees = columns.assigneeIds().begin();
+
+        for (size_t slot = first; slot < last; ++slot)
+        {
+            if (sprints[slot] != sprint_id)
+            {
+                continue;
+            }
+            TicketStatus status = statuses[slot];
+            stats.total_points += points[slot];
+            if (status == TicketStatus::Done)
+            {
+                stats.completed_points += points[slot];
+            }
+            ++stats.status_counts[static_cast<size_t>(status)];
+            load.add(assignees[slot], status, points[slot]);
+        }
+    }
+
+#ifdef SPRINT_STATS_AVX2
+    __attribute__((target("avx2")))
+    int64_t sumLanes(const __m256i& lanes)
+    {
+        alignas(32) int32_t values[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(values), lanes);
+        int64_t sum = 0;
+        for (int32_t value : values)
+        {
+            sum += value;
+        }
+        return sum;
+    }
+
+    __attribute__((target("avx2")))
+    int64_t sumLanes64(const __m256i& lanes)
+    {
+        alignas(32) int64_t values[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(values), lanes);
+        return values[0] + values[1] + values[2] + values[3];
+    }
+
+    // Widens eight 32-bit lanes and adds them to two 64-bit accumulators
+    __attribute__((target("avx2")))
+    void addWide(__m256i& low, __m256i& high, const __m256i& lanes)
+    {
+        low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(lanes)));
+        high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(lanes, 1)));
+    }
+
+    // Eight slots per step: compare the sprint column against the key, then
+    // mask story points and status counts with the result. Per-assignee
+    // load is sparse, so matching lanes are handed to the scalar map.
+    __attribute__((target("avx2")))
+    SprintStats computeAvx2(const TicketColumns& columns, int sprint_id)
+    {
+        SprintStats stats;
+        stats.sprint_id = sprint_id;
+        LoadMap load;
+
+        const int* sprints = columns.sprintIds().begin();
+        const int* points = columns.storyPoints().begin();
+        const uint8_t* statuses = reinterpret_cast<const uint8_t*>(columns.statuses().begin());
+        const int* assignees = columns.assigneeIds().begin();
+        const size_t size = columns.size();
+
+        const __m256i key = _mm256_set1_epi32(sprint_id);
+        __m256i status_keys[kTicketStatusCount];
+        for (size_t s = 0; s < kTicketStatusCount; ++s)
+        {
+            status_keys[s] = _mm256_set1_epi32(static_cast<int>(s));
+        }
+        const __m256i done = status_keys[static_cast<size_t>(TicketStatus::Done)];
+
+        // Story points may be anything an int holds, so they are summed in
+        // 64-bit lanes. Status counts grow by at most one per step and stay
+        // in 32-bit lanes, flushed once per chunk before they can overflow.
+        __m256i total_low = _mm256_setzero_si256();
+        __m256i total_high = _mm256_setzero_si256();
+        __m256i completed_low = _mm256_setzero_si256();
+        __m256i completed_high = _mm256_setzero_si256();
+        constexpr size_t kChunk = 8 << 15;
+        size_t slot = 0;
+        while (slot + 8 <= size)
+        {
+            const size_t chunk_end = std::min(size, slot + kChunk);
+            __m256i counts[kTicketStatusCount];
+            for (size_t s = 0; s < kTicketStatusCount; ++s)
+            {
+                counts[s] = _mm256_setzero_si256();
+            }
+
+            for (; slot + 8 <= chunk_end; slot += 8)
+            {
+                __m256i match = _mm256_cmpeq_epi32(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sprints + slot)), key);
+                int bits = _mm256_movemask_ps(_mm256_castsi256_ps(match));
+                if (bits == 0)
+                {
+                    continue;
+                }
+
+                __m256i status = _mm256_cvtepu8_epi32(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i*>(statuses + slot)));
+                __m256i matched_points = _mm256_and_si256(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(points + slot)), match);
+                addWide(total_low, total_high, matched_points);
+                addWide(completed_low, completed_high,
+                        _mm256_and_si256(matched_points, _mm256_cmpeq_epi32(status, done)));
+                for (size_t s = 0; s < kTicketStatusCount; ++s)
+                {
+                    // Matching lanes are -1, so subtracting counts them
+                    counts[s] = _mm256_sub_epi32(
+                        counts[s], _mm256_and_si256(match, _mm256_cmpeq_epi32(status, status_keys[s])));
+                }
+
+                if (bits == 0xFF)
+                {
+                    for (size_t lane = 0; lane < 8; ++lane)
+                    {
+                        load.add(assignees[slot + lane], static_cast<TicketStatus>(statuses[slot + lane]),
+                                 points[slot + lane]);
+                    }
+                    continue;
+                }
+                while (bits != 0)
+                {
+                    size_t lane = static_cast<size_t>(__builtin_ctz(bits));
+                    bits &= bits - 1;
+                    load.add(assignees[slot + lane], static_cast<TicketStatus>(statuses[slot + lane]),
+                             points[slot + lane]);
+                }
+            }
+
+            for (size_t s = 0; s < kTicketStatusCount; ++s)
+            {
+                stats.status_counts[s] += static_cast<size_t>(sumLanes(counts[s]));
+            }
+        }
+
+        stats.total_points = sumLanes64(total_low) + sumLanes64(total_high);
+        stats.completed_points = sumLanes64(completed_low) + sumLanes64(completed_high);
+        accumulate(columns, sprint_id, slot, size, stats, load);
+        finish(stats, load);
+        return stats;
+    }
+
+    bool cpuHasAvx2()
+    {
+        static const bool has_avx2 = __builtin_cpu_supports("avx2");
+        return has_avx2;
+    }
+#endif
+}
+
+SprintStats SprintStatsEngine::compute(const TicketColumns& columns, int sprint_id)
+{
+#ifdef SPRINT_STATS_AVX2
+    if (cpuHasAvx2())
+    {
+        return computeAvx2(columns, sprint_id);
+    }
+#endif
+    return computeScalar(columns, sprint_id);
+}
+
+SprintStats SprintStatsEngine::computeScalar(const TicketColumns& columns, int sprint_id)
+{
+    SprintStats stats;
+    stats.sprint_id = sprint_id;
+    LoadMap load;
+    accumulate(columns, sprint_id, 0, columns.size(), stats, load);
+    finish(stats, load);
+    return stats;
+}
+
+const char* SprintStatsEngine::kernelName()
+{
+#ifdef SPRINT_STATS_AVX2
+    if (cpuHasAvx2())
+    {
+        return "avx2";
+    }
+#endif
+    return "scalar";
+}
@@ -0,0 +1,58 @@
+#include "TicketColumns.hpp"
+
+void TicketColumns::clear()
+{
+    ids_.clear();
+    statuses_.clear();
+    priorities_.clear();
+    types_.clear();
+    sprint_ids_.clear();
+    assignee_ids_.clear();
+    story_points_.clear();
+    created_at_.clear();
+    updated_at_.clear();
+}
+
+void TicketColumns::assign(const std::vector<Ticket>& tickets)
+{
+    clear();
+    ids_.reserve(tickets.size());
+    statuses_.reserve(tickets.size());
+    priorities_.reserve(tickets.size());
+    types_.reserve(tickets.size());
+    sprint_ids_.reserve(tickets.size());
+    assignee_ids_.reserve(tickets.size());
+    story_points_.reserve(tickets.size());
+    created_at_.reserve(tickets.size());
+    updated_at_.reserve(tickets.size());
+    for (const auto& ticket : tickets)
+    {
+        push_back(ticket);
+    }
+}
+
+void TicketColumns::push_back(const Ticket& ticket)
+{
+    ids_.push_back(ticket.id);
+    statuses_.push_back(ticket.status);
+    priorities_.push_back(ticket.priority);
+    types_.push_back(ticket.type);
+    sprint_ids_.push_back(ticket.sprint_id);
+    assignee_ids_.push_back(ticket.assignee_id);
+    story_points_.push_back(ticket.story_points);
+    created_at_.push_back(ticket.created_at);
+    updated_at_.push_back(ticket.updated_at);
+}
+
+void TicketColumns::set(size_t slot, const Ticket& ticket)
+{
+    ids_[slot] = ticket.id;
+    statuses_[slot] = ticket.status;
+    priorities_[slot] = ticket.priority;
+    types_[slot] = ticket.type;
+    sprint_ids_[slot] = ticket.sprint_id;
+    assignee_ids_[slot] = ticket.assignee_id;
+    story_points_[slot] = ticket.story_points;
+    created_at_[slot] = ticket.created_at;
+    updated_at_[slot] = ticket.updated_at;
+}
@@ -0,0 +1,250 @@
+#include "TicketFilter.hpp"
+#include "TrigramIndex.hpp"
+#include <algorithm>
+#include <utility>
+
+TicketFilter::TicketFilter(std::chrono::milliseconds debounce, ResultCallback on_result)
+    : debounce_(debounce),
+      on_result_(std::move(on_result)),
+      thread_([this] { run(); })
+{
+}
+
+TicketFilter::~TicketFilter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+std::string TicketFilter::ticketText(const Ticket& ticket)
+{
+    return ticket.title + "\n" + ticket.description;
+}
+
+// Folding happens here once, on the filter thread, so every keystroke is a
+// plain find()
+std::unique_ptr<TicketFilter::Corpus> TicketFilter::buildCorpus(const TicketSource& source)
+{
+    auto corpus = std::make_unique<Corpus>();
+    if (!source)
+    {
+        return corpus;
+    }
+    source([&corpus](const Ticket& ticket)
+    {
+        corpus->positions[ticket.id] = corpus->ids.size();
+        corpus->ids.push_back(ticket.id);
+        corpus->text.push_back(TrigramIndex::fold(ticketText(ticket)));
+        return true;
+    });
+    return corpus;
+}
+
+void TicketFilter::reset(TicketSource source)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        incoming_ = std::move(source);
+        has_incoming_ = true;
+        // Earlier edits are already in the new text
+        edits_.clear();
+        // The current query is re-run against the new text straight away
+        if (!pending_query_.empty())
+        {
+            has_pending_ = true;
+            due_ = std::chrono::steady_clock::now();
+        }
+    }
+    wake_.notify_all();
+}
+
+void TicketFilter::update(const Ticket& ticket)
+{
+    queueEdit({ticket.id, false, ticketText(ticket)});
+}
+
+void TicketFilter::erase(int id)
+{
+    queueEdit({id, true, std::string()});
+}
+
+void TicketFilter::queueEdit(Edit edit)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        edits_.push_back(std::move(edit));
+        if (!pending_query_.empty() && !has_pending_)
+        {
+            has_pending_ = true;
+            due_ = std::chrono::steady_clock::now();
+        }
+    }
+    wake_.notify_all();
+}
+
+void TicketFilter::setQuery(const std::string& query)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_query_ = query;
+        has_pending_ = true;
+        due_ = std::chrono::steady_clock::now() + debounce_;
+    }
+    wake_.notify_all();
+}
+
+void TicketFilter::applyEdit(Corpus& corpus, Edit& edit)
+{
+    auto it = corpus.positions.find(edit.id);
+    if (!edit.erased)
+    {
+        if (it != corpus.positions.end())
+        {
+            corpus.text[it->second] = TrigramIndex::fold(edit.text);
+        }
+        else
+        {
+            corpus.positions[edit.id] = corpus.ids.size();
+            corpus.ids.push_back(edit.id);
+            corpus.text.push_back(TrigramIndex::fold(edit.text));
+        }
+        return;
+    }
+
+    if (it == corpus.positions.end())
+    {
+        return;
+    }
+    // Erase in place, as the ticket table does, so matches keep table order
+    const size_t position = it->second;
+    corpus.positions.erase(it);
+    corpus.ids.erase(corpus.ids.begin() + static_cast<std::ptrdiff_t>(position));
+    corpus.text.erase(corpus.text.begin() + static_cast<std::ptrdiff_t>(position));
+    for (size_t later = position; later < corpus.ids.size(); ++later)
+    {
+        corpus.positions[corpus.ids[later]] = later;
+    }
+}
+
+void TicketFilter::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        wake_.wait(lock, [this] { return stop_ || has_pending_ || has_incoming_; });
+
+        // A new corpus is built as soon as it arrives, while typing goes on
+        if (!stop_ && has_incoming_)
+        {
+            TicketSource incoming = std::exchange(incoming_, TicketSource());
+            has_incoming_ = false;
+            lock.unlock();
+            std::unique_ptr<Corpus> corpus = buildCorpus(incoming);
+            lock.lock();
+            // Unless a newer one arrived meanwhile
+            if (!has_incoming_)
+            {
+                corpus_ = std::move(corpus);
+                // Cached results hold corpus positions, which this drops
+                cache_.clear();
+            }
+            continue;
+        }
+
+        // Each keystroke pushes the deadline back
+        while (!stop_ && has_pending_ && !has_incoming_ && std::chrono::steady_clock::now() < due_)
+        {
+            wake_.wait_until(lock, due_);
+        }
+        if (stop_)
+        {
+            return;
+        }
+        if (!has_pending_ || has_incoming_)
+        {
+            continue;
+        }
+
+        std::string query = pending_query_;
+        std::vector<Edit> edits;
+        edits.swap(edits_);
+        has_pending_ = false;
+        lock.unlock();
+
+        // Cached results hold corpus positions, which edits change too
+        if (corpus_ && !edits.empty())
+        {
+            for (Edit& edit : edits)
+            {
+                applyEdit(*corpus_, edit);
+            }
+            cache_.clear();
+        }
+
+        if (corpus_ && !query.empty())
+        {
+            std::vector<int> ids;
+            for (size_t position : match(TrigramIndex::fold(query)))
+            {
+                ids.push_back(corpus_->ids[position]);
+            }
+            on_result_(query, std::move(ids));
+        }
+
+        lock.lock();
+    }
+}
+
+std::vector<size_t> TicketFilter::match(const std::string& query)
+{
+    const Corpus& corpus = *corpus_;
+
+    // Narrowest cached result for a query this one contains
+    const CachedResult* base = nullptr;
+    for (const auto& cached : cache_)
+    {
+        if (query.find(cached.query) != std::string::npos &&
+            (!base || cached.matches.size() < base->matches.size()))
+        {
+            base = &cached;
+        }
+    }
+    if (base && base->query == query)
+    {
+        return base->matches;
+    }
+
+    std::vector<size_t> matches;
+    auto check = [&](size_t position)
+    {
+        if (corpus.text[position].find(query) != std::string::npos)
+        {
+            matches.push_back(position);
+        }
+    };
+    if (base)
+    {
+        for (size_t position : base->matches)
+        {
+            check(position);
+        }
+    }
+    else
+    {
+        for (size_t position = 0; position < corpus.text.size(); ++position)
+        {
+            check(position);
+        }
+    }
+
+    if (cache_.size() == kCachedResults)
+    {
+        cache_.erase(cache_.begin());
+    }
+    cache_.push_back({query, matches});
+    return matches;
+}
@@ -1,5 +1,4 @@
 //TicketManager.cpp
-#include "UIManager.hpp"
 #include "DatabaseManager.hpp"
 #include "TicketManager.hpp"
 #include "SprintManager.hpp"
@@ -29,53 +28,47 @@ bool TicketManager::deleteTicket(int id)
 	return DatabaseManager::getInstance().deleteTicket(id);
 }
 
-std::vector<Ticket> TicketManager::getTicketsBySprint(int sprint_id)
+std::vector<Ticket> TicketManager::queryTickets(const TicketQuery &query)
 {
-	return DatabaseManager::getInstance().getTicketsBySprint(sprint_id);
+	return DatabaseManager::getInstance().queryTickets(query);
 }
 
-std::vector<Ticket> TicketManager::searchTickets(const std::string &query)
+TicketPage TicketManager::getTicketPage(const TicketQuery &query, size_t page_size)
 {
-	auto all_tickets = DatabaseManager::getInstance().getAllTickets();
-	std::vector<Ticket> results;
-
-	std::copy_if(all_tickets.begin(), all_tickets.end(),
-			 std::back_inserter(results),
-			 [&query](const Ticket &ticket)
-			 {
-				 return ticket.title.find(query) != std::string::npos ||
-					  ticket.description.find(query) != std::string::npos;
-			 });
+	return DatabaseManager::getInstance().queryTicketPage(query, page_size);
+}
 
-	return results;
+std::vector<Ticket> TicketManager::getTopTickets(size_t count)
+{
+	return queryTickets(TicketQuery().orderBy(TicketQuery::Order::Priority, true).limit(count));
 }
 
-std::vector<Ticket> TicketManager::getTicketsByStatus(const std::string &status)
+std::vector<Ticket> TicketManager::getTicketsBySprint(int sprint_id)
 {
-	auto all_tickets = DatabaseManager::getInstance().getAllTickets();
-	std::vector<Ticket> results;
+	return queryTickets(TicketQuery().sprint(sprint_id));
+}
 
-	std::copy_if(all_tickets.begin(), all_tickets.end(),
-			 std::back_inserter(results),
-			 [&status](const Ticket &ticket)
-			 {
-				 return ticket.status == status;
-			 });
+std::vector<Ticket> TicketManager::searchTickets(const std::string &query)
+{
+	return DatabaseManager::getInstance().searchTickets(query);
+}
 
-	return results;
+std::vector<Ticket> TicketManager::searchTicketsSubstring(const std::string &fragment)
+{
+	return DatabaseManager::getInstance().searchTicketsSubstring(fragment);
 }
 
-std::vector<Ticket> TicketManager::getTicketsByAssignee(int assignee_id)
+std::vector<Ticket> TicketManager::searchTicketsFuzzy(const std::string &fragment, int max_edits)
 {
-	auto all_tickets = DatabaseManager::getInstance().getAllTickets();
-	std::vector<Ticket> results;
+	return DatabaseManager::getInstance().searchTicketsFuzzy(fragment, max_edits);
+}
 
-	std::copy_if(all_tickets.begin(), all_tickets.end(),
-			 std::back_inserter(results),
-			 [assignee_id](const Ticket &ticket)
-			 {
-				 return ticket.assignee_id == assignee_id;
-			 });
+std::vector<Ticket> TicketManager::getTicketsByStatus(TicketStatus status)
+{
+	return queryTickets(TicketQuery().status(status));
+}
 
-	return results;
+std::vector<Ticket> TicketManager::getTicketsByAssignee(int assignee_id)
+{
+	return queryTickets(TicketQuery().assignee(assignee_id));
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "TicketOrderIndex.hpp"
+
+void TicketOrderIndex::build(TicketQuery::Order order, const std::vector<Ticket>& tickets)
+{
+    if (order == TicketQuery::Order::None)
+    {
+        return;
+    }
+
+    const size_t index = static_cast<size_t>(order);
+    orders_[index].clear();
+    for (const auto& ticket : tickets)
+    {
+        orders_[index].insert(TicketQuery::sortKey(order, ticket));
+    }
+    built_[index] = true;
+}
+
+void TicketOrderIndex::clear()
+{
+    for (size_t index = 0; index < orders_.size(); ++index)
+    {
+        orders_[index].clear();
+        built_[index] = false;
+    }
+}
+
+void TicketOrderIndex::add(const Ticket& ticket)
+{
+    for (size_t index = 0; index < orders_.size(); ++index)
+    {
+        if (built_[index])
+        {
+            orders_[index].insert(TicketQuery::sortKey(static_cast<TicketQuery::Order>(index), ticket));
+        }
+    }
+}
+
+void TicketOrderIndex::remove(const Ticket& ticket)
+{
+    for (size_t index = 0; index < orders_.size(); ++index)
+    {
+        if (built_[index])
+        {
+            orders_[index].erase(TicketQuery::sortKey(static_cast<TicketQuery::Order>(index), ticket));
+        }
+    }
+}
+
+const TicketOrderIndex::Entries* TicketOrderIndex::entries(TicketQuery::Order order) const
+{
+    const size_t index = static_cast<size_t>(order);
+    return built_[index] ? &orders_[index] : nullptr;
+}
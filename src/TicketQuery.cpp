@@ -0,0 +1,355 @@
+#include "TicketQuery.hpp"
+#include "ProjectData.hpp"
+#include "TicketOrderIndex.hpp"
+#include "TrigramIndex.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    using IdSet = std::unordered_set<int>;
+
+    template <typename Key>
+    const IdSet* postings(const std::unordered_map<Key, IdSet>& index, const Key& key)
+    {
+        auto it = index.find(key);
+        return it != index.end() ? &it->second : nullptr;
+    }
+}
+
+TicketQuery& TicketQuery::status(TicketStatus status)
+{
+    status_mask_ |= static_cast<uint8_t>(1u << static_cast<unsigned>(status));
+    return *this;
+}
+
+TicketQuery& TicketQuery::assignee(int assignee_id)
+{
+    assignee_id_ = assignee_id;
+    return *this;
+}
+
+TicketQuery& TicketQuery::sprint(int sprint_id)
+{
+    sprint_id_ = sprint_id;
+    return *this;
+}
+
+TicketQuery& TicketQuery::storyPoints(int min_points, int max_points)
+{
+    min_points_ = min_points;
+    max_points_ = max_points;
+    return *this;
+}
+
+TicketQuery& TicketQuery::text(const std::string& fragment)
+{
+    text_ = TrigramIndex::fold(fragment);
+    return *this;
+}
+
+TicketQuery& TicketQuery::updatedAfter(time_t time)
+{
+    has_updated_after_ = true;
+    updated_after_ = time;
+    return *this;
+}
+
+TicketQuery& TicketQuery::orderBy(Order order, bool descending)
+{
+    order_ = order;
+    descending_ = descending;
+    return *this;
+}
+
+TicketQuery& TicketQuery::limit(size_t count)
+{
+    limit_ = count;
+    return *this;
+}
+
+TicketQuery& TicketQuery::after(const TicketSortKey& cursor)
+{
+    has_cursor_ = true;
+    cursor_ = cursor;
+    return *this;
+}
+
+void TicketQuery::run(const ProjectData& data, const Visitor& visit) const
+{
+    if (limit_ == 0)
+    {
+        return;
+    }
+
+    // Drive the walk from the smallest posting list, provided it is small
+    // enough that finding each id's slot beats a sequential scan of the
+    // columns. An equality predicate with no postings matches nothing.
+    std::vector<const IdSet*> driver;
+    size_t driver_size = data.tickets.size();
+    auto offer = [&](std::vector<const IdSet*> lists)
+    {
+        size_t size = 0;
+        for (const IdSet* list : lists)
+        {
+            size += list->size();
+        }
+        if (size < driver_size && size * kScanRatio < data.tickets.size())
+        {
+            driver = std::move(lists);
+            driver_size = size;
+        }
+    };
+
+    if (assignee_id_ != kAnyId)
+    {
+        const IdSet* list = postings(data.tickets_by_assignee, assignee_id_);
+        if (!list)
+        {
+            return;
+        }
+        offer({list});
+    }
+    if (sprint_id_ != kAnyId)
+    {
+        const IdSet* list = postings(data.tickets_by_sprint, sprint_id_);
+        if (!list)
+        {
+            return;
+        }
+        offer({list});
+    }
+    if (status_mask_ != 0)
+    {
+        std::vector<const IdSet*> lists;
+        for (size_t status = 0; status < kTicketStatusCount; ++status)
+        {
+            if (status_mask_ & (1u << status))
+            {
+                if (const IdSet* list = postings(data.tickets_by_status, static_cast<TicketStatus>(status)))
+                {
+                    lists.push_back(list);
+                }
+            }
+        }
+        if (lists.empty())
+        {
+            return;
+        }
+        offer(std::move(lists));
+    }
+
+    // Text goes through the trigram index under the same rule, judged by
+    // its shortest posting list before paying for the merge. Candidates
+    // come sorted by id.
+    std::vector<int> text_ids;
+    bool by_text = false;
+    if (!text_.empty() && data.trigram_index.built() && driver_size > kVerifyDirectly)
+    {
+        const size_t bound = data.trigram_index.substringCandidateBound(text_);
+        by_text = bound < driver_size && bound * kScanRatio < data.tickets.size() &&
+                  data.trigram_index.substringCandidates(text_, text_ids);
+    }
+    if (by_text)
+    {
+        driver_size = text_ids.size();
+    }
+
+    // Every predicate, the driving one included, is checked on the columns;
+    // only the text check reads the row
+    const TicketColumns& columns = data.ticket_columns;
+    const RecordView<int> ids = columns.ids();
+    const RecordView<TicketStatus> statuses = columns.statuses();
+    const RecordView<int> assignees = columns.assigneeIds();
+    const RecordView<int> sprints = columns.sprintIds();
+    const RecordView<int> points = columns.storyPoints();
+    const RecordView<time_t> updated = columns.updatedAt();
+    auto accepts = [&](size_t slot)
+    {
+        if (status_mask_ != 0 && !(status_mask_ & (1u << static_cast<unsigned>(statuses[slot]))))
+        {
+            return false;
+        }
+        if ((assignee_id_ != kAnyId && assignees[slot] != assignee_id_) ||
+            (sprint_id_ != kAnyId && sprints[slot] != sprint_id_) ||
+            points[slot] < min_points_ || points[slot] > max_points_ ||
+            (has_updated_after_ && updated[slot] <= updated_after_))
+        {
+            return false;
+        }
+        if (!text_.empty())
+        {
+            const Ticket& ticket = data.tickets[slot];
+            return TrigramIndex::contains(ticket.title, text_) || TrigramIndex::contains(ticket.description, text_);
+        }
+        return true;
+    };
+
+    // Feeds candidate slots to `step` until it returns false
+    auto walk = [&](auto&& step)
+    {
+        if (by_text)
+        {
+            for (int id : text_ids)
+            {
+                if (!step(data.ticket_slots.at(id)))
+                {
+                    return;
+                }
+            }
+        }
+        else if (!driver.empty())
+        {
+            for (const IdSet* list : driver)
+            {
+                for (int id : *list)
+                {
+                    if (!step(data.ticket_slots.at(id)))
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (size_t slot = 0; slot < columns.size(); ++slot)
+            {
+                if (!step(slot))
+                {
+                    return;
+                }
+            }
+        }
+    };
+
+    auto keyAt = [&](size_t slot)
+    {
+        TicketSortKey key;
+        key.id = ids[slot];
+        switch (order_)
+        {
+        case Order::CreatedAt:   key.primary = columns.createdAt()[slot]; break;
+        case Order::UpdatedAt:   key.primary = updated[slot]; break;
+        case Order::Priority:    key.primary = static_cast<long long>(columns.priorities()[slot]);
+                                 key.secondary = updated[slot]; break;
+        case Order::StoryPoints: key.primary = points[slot]; break;
+        default:                 key.primary = ids[slot]; break;
+        }
+        return key;
+    };
+    auto before = [this](const TicketSortKey& a, const TicketSortKey& b)
+    {
+        return descending_ ? b < a : a < b;
+    };
+    auto take = [&](size_t slot)
+    {
+        return accepts(slot) && (!has_cursor_ || before(cursor_, keyAt(slot)));
+    };
+
+    // Unordered, or already in the requested order: stream
+    if (order_ == Order::None || (order_ == Order::Id && !descending_ && by_text))
+    {
+        size_t emitted = 0;
+        walk([&](size_t slot)
+        {
+            if (!take(slot))
+            {
+                return true;
+            }
+            return visit(data.tickets[slot]) && ++emitted < limit_;
+        });
+        return;
+    }
+
+    // Nothing narrows the walk: go through the tickets in order from the
+    // cursor until the page is full
+    const TicketOrderIndex::Entries* ordered =
+        driver.empty() && !by_text ? data.order_index.entries(order_) : nullptr;
+    if (ordered)
+    {
+        size_t emitted = 0;
+        auto step = [&](const TicketSortKey& key)
+        {
+            const size_t slot = data.ticket_slots.at(key.id);
+            if (!accepts(slot))
+            {
+                return true;
+            }
+            return visit(data.tickets[slot]) && ++emitted < limit_;
+        };
+        if (!descending_)
+        {
+            for (auto it = has_cursor_ ? ordered->upper_bound(cursor_) : ordered->begin(); it != ordered->end(); ++it)
+            {
+                if (!step(*it))
+                {
+                    return;
+                }
+            }
+        }
+        else
+        {
+            for (auto it = has_cursor_ ? ordered->lower_bound(cursor_) : ordered->end(); it != ordered->begin();)
+            {
+                if (!step(*--it))
+                {
+                    return;
+                }
+            }
+        }
+        return;
+    }
+
+    // Keep the best `limit` matches in a heap whose top is the worst of them
+    using Match = std::pair<TicketSortKey, size_t>;
+    std::vector<Match> best;
+    auto worse = [&before](const Match& a, const Match& b) { return before(a.first, b.first); };
+    walk([&](size_t slot)
+    {
+        if (!take(slot))
+        {
+            return true;
+        }
+        const TicketSortKey key = keyAt(slot);
+        if (best.size() < limit_)
+        {
+            best.emplace_back(key, slot);
+            std::push_heap(best.begin(), best.end(), worse);
+        }
+        else if (before(key, best.front().first))
+        {
+            std::pop_heap(best.begin(), best.end(), worse);
+            best.back() = Match(key, slot);
+            std::push_heap(best.begin(), best.end(), worse);
+        }
+        return true;
+    });
+
+    std::sort_heap(best.begin(), best.end(), worse);
+    for (const Match& match : best)
+    {
+        if (!visit(data.tickets[match.second]))
+        {
+            return;
+        }
+    }
+}
+
+TicketSortKey TicketQuery::sortKey(Order order, const Ticket& ticket)
+{
+    TicketSortKey key;
+    key.id = ticket.id;
+    switch (order)
+    {
+    case Order::CreatedAt:   key.primary = ticket.created_at; break;
+    case Order::UpdatedAt:   key.primary = ticket.updated_at; break;
+    case Order::Priority:    key.primary = static_cast<long long>(ticket.priority);
+                             key.secondary = ticket.updated_at; break;
+    case Order::StoryPoints: key.primary = ticket.story_points; break;
+    default:                 key.primary = ticket.id; break;
+    }
+    return key;
+}
@@ -0,0 +1,310 @@
+#include "TicketSearchIndex.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    // Bytes of multi-byte UTF-8 sequences count as word characters, so
+    // non-ASCII words stay whole even though only ASCII is case-folded
+    bool isWordByte(unsigned char c)
+    {
+        return std::isalnum(c) || c >= 0x80;
+    }
+
+    bool idLess(uint32_t a, uint32_t b)
+    {
+        return (a >> 1) < (b >> 1);
+    }
+}
+
+void TicketSearchIndex::tokenize(const std::string& text, std::vector<std::string>& terms)
+{
+    std::string term;
+    for (unsigned char c : text)
+    {
+        if (isWordByte(c))
+        {
+            term.push_back(static_cast<char>(std::tolower(c)));
+        }
+        else if (!term.empty())
+        {
+            terms.push_back(std::move(term));
+            term.clear();
+        }
+    }
+    if (!term.empty())
+    {
+        terms.push_back(std::move(term));
+    }
+}
+
+void TicketSearchIndex::collectTerms(const Ticket& ticket, TicketTerms& terms)
+{
+    std::vector<std::string> words;
+    tokenize(ticket.title, words);
+    for (auto& word : words)
+    {
+        terms.emplace_back(std::move(word), true);
+    }
+    words.clear();
+    tokenize(ticket.description, words);
+    for (auto& word : words)
+    {
+        terms.emplace_back(std::move(word), false);
+    }
+
+    // Title occurrences sort first, so unique() keeps the flagged copy
+    std::sort(terms.begin(), terms.end(),
+              [](const auto& a, const auto& b) { return a.first != b.first ? a.first < b.first : a.second > b.second; });
+    terms.erase(std::unique(terms.begin(), terms.end(),
+                            [](const auto& a, const auto& b) { return a.first == b.first; }),
+                terms.end());
+}
+
+TicketSearchIndex::PostingList& TicketSearchIndex::listFor(const std::string& term)
+{
+    auto it = postings_.find(term);
+    if (it == postings_.end())
+    {
+        terms_.insert(term);
+        it = postings_.emplace(term, PostingList{}).first;
+    }
+    return it->second;
+}
+
+void TicketSearchIndex::dropList(const std::string& term)
+{
+    postings_.erase(term);
+    terms_.erase(term);
+}
+
+void TicketSearchIndex::build(const std::vector<Ticket>& tickets)
+{
+    // Append everything, then sort each list once; the row table is in
+    // insertion order, which need not be id order
+    clear();
+    TicketTerms terms;
+    for (const auto& ticket : tickets)
+    {
+        terms.clear();
+        collectTerms(ticket, terms);
+        for (const auto& term : terms)
+        {
+            listFor(term.first).push_back((static_cast<Posting>(ticket.id) << 1) | term.second);
+        }
+    }
+    for (auto& entry : postings_)
+    {
+        std::sort(entry.second.begin(), entry.second.end());
+    }
+    built_ = true;
+}
+
+void TicketSearchIndex::clear()
+{
+    postings_.clear();
+    terms_.clear();
+    built_ = false;
+}
+
+void TicketSearchIndex::add(const Ticket& ticket)
+{
+    if (!built_)
+    {
+        return;
+    }
+
+    TicketTerms terms;
+    collectTerms(ticket, terms);
+    for (const auto& term : terms)
+    {
+        Posting posting = (static_cast<Posting>(ticket.id) << 1) | term.second;
+        PostingList& list = listFor(term.first);
+        // New tickets have the highest id, so this is almost always an append
+        if (list.empty() || idLess(list.back(), posting))
+        {
+            list.push_back(posting);
+        }
+        else
+        {
+            list.insert(std::lower_bound(list.begin(), list.end(), posting, idLess), posting);
+        }
+    }
+}
+
+void TicketSearchIndex::remove(const Ticket& ticket)
+{
+    if (!built_)
+    {
+        return;
+    }
+
+    TicketTerms terms;
+    collectTerms(ticket, terms);
+    const Posting key = static_cast<Posting>(ticket.id) << 1;
+    for (const auto& term : terms)
+    {
+        auto entry = postings_.find(term.first);
+        if (entry == postings_.end())
+        {
+            continue;
+        }
+        PostingList& list = entry->second;
+        auto it = std::lower_bound(list.begin(), list.end(), key, idLess);
+        if (it != list.end() && postingId(*it) == ticket.id)
+        {
+            list.erase(it);
+        }
+        if (list.empty())
+        {
+            dropList(term.first);
+        }
+    }
+}
+
+TicketSearchIndex::PostingList TicketSearchIndex::prefixPostings(const std::string& prefix) const
+{
+    PostingList merged;
+    for (auto it = terms_.lower_bound(prefix);
+         it != terms_.end() && it->compare(0, prefix.size(), prefix) == 0; ++it)
+    {
+        const PostingList& list = postings_.at(*it);
+        merged.insert(merged.end(), list.begin(), list.end());
+    }
+    std::sort(merged.begin(), merged.end());
+
+    // One entry per ticket, in the title if any matching term is
+    PostingList unique;
+    unique.reserve(merged.size());
+    for (Posting posting : merged)
+    {
+        if (!unique.empty() && postingId(unique.back()) == postingId(posting))
+        {
+            unique.back() |= posting;
+        }
+        else
+        {
+            unique.push_back(posting);
+        }
+    }
+    return unique;
+}
+
+std::vector<int> TicketSearchIndex::search(const std::string& query, size_t limit) const
+{
+    std::vector<int> ids;
+
+    // Exact terms point straight at their lists; prefix terms are merged
+    // into owned lists first
+    std::vector<const PostingList*> lists;
+    std::vector<PostingList> merged;
+    std::string piece;
+    auto addPiece = [&]()
+    {
+        if (piece.empty())
+        {
+            return true;
+        }
+        const bool prefix = piece.back() == '*';
+        std::vector<std::string> terms;
+        tokenize(piece, terms);
+        piece.clear();
+        for (size_t i = 0; i < terms.size(); ++i)
+        {
+            if (prefix && i + 1 == terms.size())
+            {
+                merged.push_back(prefixPostings(terms[i]));
+                if (merged.back().empty())
+                {
+                    return false;
+                }
+                continue;
+            }
+            auto it = postings_.find(terms[i]);
+            if (it == postings_.end())
+            {
+                return false;
+            }
+            lists.push_back(&it->second);
+        }
+        return true;
+    };
+
+    for (char c : query)
+    {
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            if (!addPiece())
+            {
+                return ids;
+            }
+        }
+        else
+        {
+            piece.push_back(c);
+        }
+    }
+    if (!addPiece())
+    {
+        return ids;
+    }
+    for (const auto& list : merged)
+    {
+        lists.push_back(&list);
+    }
+    if (lists.empty() || limit == 0)
+    {
+        return ids;
+    }
+
+    // Walk the shortest list and probe the others with forward-only
+    // binary searches. A hit ranks as a title match only when every term
+    // hit the title; once `limit` title matches are found nothing later
+    // can displace them, so the walk stops.
+    std::sort(lists.begin(), lists.end(),
+              [](const PostingList* a, const PostingList* b) { return a->size() < b->size(); });
+    std::vector<PostingList::const_iterator> cursors;
+    for (const PostingList* list : lists)
+    {
+        cursors.push_back(list->begin());
+    }
+
+    std::vector<int> title_hits;
+    std::vector<int> other_hits;
+    for (Posting posting : *lists.front())
+    {
+        bool title = inTitle(posting);
+        bool matched = true;
+        for (size_t l = 1; l < lists.size() && matched; ++l)
+        {
+            auto& cursor = cursors[l];
+            cursor = std::lower_bound(cursor, lists[l]->end(), posting, idLess);
+            matched = cursor != lists[l]->end() && postingId(*cursor) == postingId(posting);
+            title = title && matched && inTitle(*cursor);
+        }
+        if (!matched)
+        {
+            continue;
+        }
+
+        if (title)
+        {
+            title_hits.push_back(postingId(posting));
+            if (title_hits.size() >= limit)
+            {
+                break;
+            }
+        }
+        else if (other_hits.size() < limit)
+        {
+            other_hits.push_back(postingId(posting));
+        }
+    }
+
+    ids = std::move(title_hits);
+    for (size_t i = 0; i < other_hits.size() && ids.size() < limit; ++i)
+    {
+        ids.push_back(other_hits[i]);
+    }
+    return ids;
+}
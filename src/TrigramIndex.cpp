@@ -0,0 +1,334 @@
+#include "TrigramIndex.hpp"
+#include <algorithm>
+
+namespace
+{
+    char foldByte(char c)
+    {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    uint32_t trigramAt(const std::string& text, size_t i)
+    {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(foldByte(text[i]))) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(foldByte(text[i + 1]))) << 8) |
+               static_cast<uint32_t>(static_cast<unsigned char>(foldByte(text[i + 2])));
+    }
+
+    void appendTrigrams(const std::string& text, std::vector<uint32_t>& trigrams)
+    {
+        for (size_t i = 0; i + 3 <= text.size(); ++i)
+        {
+            trigrams.push_back(trigramAt(text, i));
+        }
+    }
+
+    void sortUnique(std::vector<uint32_t>& trigrams)
+    {
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    }
+}
+
+// Title and description are indexed separately, so no trigram spans the
+// two fields
+void TrigramIndex::collectTrigrams(const Ticket& ticket, std::vector<uint32_t>& trigrams)
+{
+    appendTrigrams(ticket.title, trigrams);
+    appendTrigrams(ticket.description, trigrams);
+    sortUnique(trigrams);
+}
+
+void TrigramIndex::fragmentTrigrams(const std::string& fragment, std::vector<uint32_t>& trigrams)
+{
+    appendTrigrams(fragment, trigrams);
+    sortUnique(trigrams);
+}
+
+void TrigramIndex::build(const std::vector<Ticket>& tickets)
+{
+    clear();
+    std::vector<uint32_t> trigrams;
+    for (const auto& ticket : tickets)
+    {
+        trigrams.clear();
+        collectTrigrams(ticket, trigrams);
+        for (uint32_t trigram : trigrams)
+        {
+            postings_[trigram].push_back(ticket.id);
+        }
+    }
+    for (auto& entry : postings_)
+    {
+        std::sort(entry.second.begin(), entry.second.end());
+    }
+    built_ = true;
+}
+
+void TrigramIndex::clear()
+{
+    postings_.clear();
+    built_ = false;
+}
+
+void TrigramIndex::add(const Ticket& ticket)
+{
+    if (!built_)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> trigrams;
+    collectTrigrams(ticket, trigrams);
+    for (uint32_t trigram : trigrams)
+    {
+        PostingList& list = postings_[trigram];
+        if (list.empty() || list.back() < ticket.id)
+        {
+            list.push_back(ticket.id);
+        }
+        else
+        {
+            list.insert(std::lower_bound(list.begin(), list.end(), ticket.id), ticket.id);
+        }
+    }
+}
+
+void TrigramIndex::remove(const Ticket& ticket)
+{
+    if (!built_)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> trigrams;
+    collectTrigrams(ticket, trigrams);
+    for (uint32_t trigram : trigrams)
+    {
+        auto entry = postings_.find(trigram);
+        if (entry == postings_.end())
+        {
+            continue;
+        }
+        PostingList& list = entry->second;
+        auto it = std::lower_bound(list.begin(), list.end(), ticket.id);
+        if (it != list.end() && *it == ticket.id)
+        {
+            list.erase(it);
+        }
+        if (list.empty())
+        {
+            postings_.erase(entry);
+        }
+    }
+}
+
+bool TrigramIndex::substringCandidates(const std::string& fragment, std::vector<int>& ids) const
+{
+    ids.clear();
+    std::vector<uint32_t> trigrams;
+    fragmentTrigrams(fragment, trigrams);
+    if (trigrams.empty())
+    {
+        return false;
+    }
+
+    // Every trigram must be present; intersect from the shortest list
+    std::vector<const PostingList*> lists;
+    for (uint32_t trigram : trigrams)
+    {
+        auto it = postings_.find(trigram);
+        if (it == postings_.end())
+        {
+            return true;
+        }
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const PostingList* a, const PostingList* b) { return a->size() < b->size(); });
+
+    ids = *lists.front();
+    for (size_t l = 1; l < lists.size() && !ids.empty(); ++l)
+    {
+        const PostingList& other = *lists[l];
+        auto cursor = other.begin();
+        size_t kept = 0;
+        for (int id : ids)
+        {
+            cursor = std::lower_bound(cursor, other.end(), id);
+            if (cursor == other.end())
+            {
+                break;
+            }
+            if (*cursor == id)
+            {
+                ids[kept++] = id;
+            }
+        }
+        ids.resize(kept);
+    }
+    return true;
+}
+
+size_t TrigramIndex::substringCandidateBound(const std::string& fragment) const
+{
+    std::vector<uint32_t> trigrams;
+    fragmentTrigrams(fragment, trigrams);
+    if (trigrams.empty())
+    {
+        return SIZE_MAX;
+    }
+
+    size_t bound = SIZE_MAX;
+    for (uint32_t trigram : trigrams)
+    {
+        auto it = postings_.find(trigram);
+        bound = std::min(bound, it != postings_.end() ? it->second.size() : size_t(0));
+    }
+    return bound;
+}
+
+bool TrigramIndex::fuzzyCandidates(const std::string& fragment, int max_edits, std::vector<int>& ids) const
+{
+    ids.clear();
+    std::vector<uint32_t> trigrams;
+    fragmentTrigrams(fragment, trigrams);
+    const long required = static_cast<long>(trigrams.size()) - 3L * std::max(max_edits, 0);
+    if (required <= 0)
+    {
+        return false;
+    }
+
+    // Count, per ticket, how many of the fragment's trigrams it holds
+    std::vector<int> hits;
+    for (uint32_t trigram : trigrams)
+    {
+        auto it = postings_.find(trigram);
+        if (it != postings_.end())
+        {
+            hits.insert(hits.end(), it->second.begin(), it->second.end());
+        }
+    }
+    std::sort(hits.begin(), hits.end());
+    for (size_t i = 0; i < hits.size();)
+    {
+        size_t run = i;
+        while (run < hits.size() && hits[run] == hits[i])
+        {
+            ++run;
+        }
+        if (static_cast<long>(run - i) >= required)
+        {
+            ids.push_back(hits[i]);
+        }
+        i = run;
+    }
+    return true;
+}
+
+std::string TrigramIndex::fold(const std::string& text)
+{
+    std::string folded = text;
+    std::transform(folded.begin(), folded.end(), folded.begin(), foldByte);
+    return folded;
+}
+
+bool TrigramIndex::contains(const std::string& text, const std::string& folded_fragment)
+{
+    return std::search(text.begin(), text.end(), folded_fragment.begin(), folded_fragment.end(),
+                       [](char a, char b) { return foldByte(a) == b; }) != text.end();
+}
+
+FuzzyMatcher::FuzzyMatcher(const std::string& fragment, int max_edits)
+    : fragment_(TrigramIndex::fold(fragment)), max_edits_(std::max(max_edits, 0))
+{
+    if (fragment_.size() <= 64)
+    {
+        for (size_t i = 0; i < fragment_.size(); ++i)
+        {
+            peq_[static_cast<unsigned char>(fragment_[i])] |= uint64_t(1) << i;
+        }
+    }
+}
+
+int FuzzyMatcher::distance(const std::string& text) const
+{
+    const size_t m = fragment_.size();
+    if (m == 0)
+    {
+        return 0;
+    }
+    if (m > 64)
+    {
+        return dynamicDistance(text);
+    }
+
+    // Myers (1999): the vertical deltas of one DP column are kept as two
+    // bit vectors, and the score tracks the bottom cell. A match may start
+    // anywhere in the text, so no carry enters the top row.
+    const uint64_t last = uint64_t(1) << (m - 1);
+    uint64_t pv = ~uint64_t(0);
+    uint64_t mv = 0;
+    int score = static_cast<int>(m);
+    int best = score;
+    for (char c : text)
+    {
+        const uint64_t eq = peq_[static_cast<unsigned char>(foldByte(c))];
+        const uint64_t xv = eq | mv;
+        const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & last)
+        {
+            ++score;
+        }
+        else if (mh & last)
+        {
+            --score;
+        }
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        best = std::min(best, score);
+        if (best == 0)
+        {
+            break;
+        }
+    }
+    return std::min(best, max_edits_ + 1);
+}
+
+// Sellers' variant of edit distance: the top row is all zeros and the
+// answer is the best bottom cell
+int FuzzyMatcher::dynamicDistance(const std::string& text) const
+{
+    const size_t m = fragment_.size();
+    std::vector<int> column(m + 1);
+    for (size_t i = 0; i <= m; ++i)
+    {
+        column[i] = static_cast<int>(i);
+    }
+
+    int best = static_cast<int>(m);
+    for (char c : text)
+    {
+        const char folded = foldByte(c);
+        int diagonal = 0;
+        column[0] = 0;
+        for (size_t i = 1; i <= m; ++i)
+        {
+            int above = column[i];
+            column[i] = std::min({diagonal + (fragment_[i - 1] != folded ? 1 : 0),
+                                  above + 1, column[i - 1] + 1});
+            diagonal = above;
+        }
+        best = std::min(best, column[m]);
+        if (best == 0)
+        {
+            break;
+        }
+    }
+    return std::min(best, max_edits_ + 1);
+}
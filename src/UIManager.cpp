@@ -5,6 +5,7 @@
 #include "TicketManager.hpp"
 #include "SprintManager.hpp"
 #include "models.hpp"
+#include "ftxui/screen/terminal.hpp"
 #include <iomanip>
 #include <sstream>
 #include <thread>
@@ -12,26 +13,51 @@
 #include <ctime>
 #include <algorithm>
 #include <cstdio>
+#include <cstdlib>
 
 using namespace ftxui;
 
 /* ========================== Constructor & Lifecycle ========================== */
 UIManager::UIManager()
     : screen_(ScreenInteractive::Fullscreen()) {
+    debug_frames_ = std::getenv("RETRO_SCRUM_DEBUG") != nullptr;
     initializeComponents();
+    ticket_filter_ = std::make_unique<TicketFilter>(
+        std::chrono::milliseconds(kSearchDebounceMs),
+        [this](const std::string& query, std::vector<int> ids) {
+            screen_.Post([this, query, ids = std::move(ids)]() mutable {
+                applySearchResults(query, std::move(ids));
+            });
+            screen_.PostEvent(Event::Custom);
+        });
+    change_subscription_ = DatabaseManager::getInstance().subscribe(
+        [this](const ChangeEvent& change) {
+            // A write made here, from a key handler, shows in the frame it
+            // triggers; anything else waits its turn on this thread
+            if (std::this_thread::get_id() == ui_thread_) {
+                applyChange(change);
+                return;
+            }
+            screen_.Post([this, change] { applyChange(change); });
+            screen_.PostEvent(Event::Custom);
+        });
     loadData();
     
     // Initialize default ticket
     current_ticket_ = Ticket();
-    current_ticket_.status = "todo";
-    current_ticket_.priority = "medium";
-    current_ticket_.type = "task";
+    current_ticket_.status = TicketStatus::Todo;
+    current_ticket_.priority = TicketPriority::Medium;
+    current_ticket_.type = TicketType::Task;
     
     // Initialize default sprint
     current_sprint_ = Sprint();
     current_sprint_.status = "planned";
 }
 
+UIManager::~UIManager() {
+    DatabaseManager::getInstance().unsubscribe(change_subscription_);
+}
+
 void UIManager::run() {
     screen_.Loop(main_container_);
 }
@@ -51,16 +77,95 @@ void UIManager::initializeComponents() {
 
 void UIManager::loadData() {
     DatabaseManager& db = DatabaseManager::getInstance();
-    sprints_    = db.getAllSprints();
-    tickets_    = db.getAllTickets();
-    activities_ = db.getRecentActivities(10);
-    users_      = db.getAllUsers();
+    sprints_      = db.getSprintsView();
+    activities_   = db.getRecentActivitiesView(10);
+    users_        = db.getUsersView();
+    
+    // The filter searches its own copy of the ticket text, read on its
+    // thread; refresh it now if a search is showing, otherwise when the
+    // next one starts
+    search_corpus_stale_ = true;
+    if (!search_query_.empty()) {
+        ticket_filter_->reset(searchSource());
+        search_corpus_stale_ = false;
+        search_pending_ = true;
+    }
+    loadTicketRows();
+}
+
+// Copies only ticket text, straight from the rows (or a lazy project's
+// mapping), so neither snapshot tables nor decoded tickets are forced
+TicketFilter::TicketSource UIManager::searchSource() {
+    return [](const std::function<bool(const Ticket&)>& visit) {
+        DatabaseManager::getInstance().visitTickets(visit);
+    };
+}
+
+void UIManager::loadTicketRows() {
+    DatabaseManager& db = DatabaseManager::getInstance();
+    ticket_count_ = search_query_.empty() ? db.getTicketCount() : search_ids_.size();
+    ticket_window_.fit(ticket_window_.rows, ticket_count_);
+    ++ticket_rows_version_;
+    
+    const size_t first = ticket_window_.first;
+    if (search_query_.empty()) {
+        tickets_ = db.getTicketsInRange(first, ticket_window_.rows);
+    } else {
+        // Results may trail a delete by one refresh; skip ids that are gone
+        tickets_.clear();
+        for (size_t i = first; i < search_ids_.size() && i < first + ticket_window_.rows; ++i) {
+            Ticket ticket = db.getTicket(search_ids_[i]);
+            if (ticket.id != 0) {
+                tickets_.push_back(std::move(ticket));
+            }
+        }
+    }
 }
 
 void UIManager::refreshData() { 
     loadData(); 
 }
 
+// Writes no longer reload everything: each change refreshes only the view
+// it affects. Views are re-fetched rather than patched, since a write can
+// move the table they point into; that costs nothing, and for tickets only
+// the rows in the window are read again.
+void UIManager::applyChange(const ChangeEvent& change) {
+    DatabaseManager& db = DatabaseManager::getInstance();
+    switch (change.entity) {
+    case ChangeEntity::Project:
+        loadData();
+        break;
+    case ChangeEntity::User:
+        users_ = db.getUsersView();
+        break;
+    case ChangeEntity::Sprint:
+        sprints_ = db.getSprintsView();
+        break;
+    case ChangeEntity::Activity:
+        activities_ = db.getRecentActivitiesView(10);
+        break;
+    case ChangeEntity::Ticket: {
+        // The filter's copy of the text takes the one edit
+        if (!search_corpus_stale_) {
+            if (change.kind == ChangeKind::Deleted) {
+                ticket_filter_->erase(change.id);
+            } else {
+                ticket_filter_->update(db.getTicket(change.id));
+            }
+            search_pending_ = !search_query_.empty();
+        }
+        // An edit to a ticket outside the window changes nothing drawn
+        bool shown = std::any_of(tickets_.begin(), tickets_.end(),
+                                 [&change](const Ticket& t) { return t.id == change.id; });
+        if (change.kind != ChangeKind::Updated || shown) {
+            loadTicketRows();
+        }
+        break;
+    }
+    }
+}
+
 /* ========================== Input Handling ========================== */
 bool UIManager::handleGlobalInput(Event event) {
     // Handle form-specific input first
@@ -78,6 +183,10 @@ bool UIManager::handleGlobalInput(Event event) {
         return false; // Let form handle other input
     }
     
+    if (handleSearchInput(event)) {
+        return true;
+    }
+    
     // Global shortcuts
     if (event == Event::Character('q') || event == Event::Character('Q')) {
         screen_.Exit();
@@ -126,31 +235,108 @@ bool UIManager::handleGlobalInput(Event event) {
     }
     
     // Navigation in panes
-    if (event == Event::ArrowUp) {
-        if (current_focus_ == FocusPane::SPRINTS && selected_sprint_ > 0) {
-            selected_sprint_--;
+    if (event == Event::ArrowUp)   return scrollFocusedPane(-1);
+    if (event == Event::ArrowDown) return scrollFocusedPane(1);
+    if (event == Event::PageUp || event == Event::PageDown) {
+        const ListWindow& window = current_focus_ == FocusPane::SPRINTS ? sprint_window_ : ticket_window_;
+        return scrollFocusedPane(event == Event::PageUp ? -long(window.rows) : long(window.rows));
+    }
+    if (event == Event::Home) return scrollFocusedPane(-long(std::max(sprints_.size(), ticket_count_)));
+    if (event == Event::End)  return scrollFocusedPane(long(std::max(sprints_.size(), ticket_count_)));
+    
+    return false;
+}
+
+bool UIManager::scrollFocusedPane(long delta) {
+    if (current_focus_ == FocusPane::SPRINTS) {
+        sprint_window_.move(delta, sprints_.size());
+        return true;
+    }
+    if (current_focus_ == FocusPane::TICKETS) {
+        if (ticket_window_.move(delta, ticket_count_)) {
+            loadTicketRows();
+        }
+        return true;
+    }
+    return false;
+}
+
+bool UIManager::handleSearchInput(Event event) {
+    if (!search_typing_) {
+        if (event == Event::Character('/')) {
+            search_typing_ = true;
+            current_focus_ = FocusPane::TICKETS;
+            if (search_corpus_stale_) {
+                ticket_filter_->reset(searchSource());
+                search_corpus_stale_ = false;
+            }
             return true;
         }
-        if (current_focus_ == FocusPane::TICKETS && selected_ticket_ > 0) {
-            selected_ticket_--;
+        if (event == Event::Escape && !search_query_.empty()) {
+            search_query_.clear();
+            updateSearch();
             return true;
         }
+        return false;
     }
     
-    if (event == Event::ArrowDown) {
-        if (current_focus_ == FocusPane::SPRINTS && selected_sprint_ < int(sprints_.size()) - 1) {
-            selected_sprint_++;
-            return true;
+    if (event == Event::Escape) {
+        search_typing_ = false;
+        search_query_.clear();
+        updateSearch();
+        return true;
+    }
+    if (event == Event::Return) {
+        search_typing_ = false;
+        return true;
+    }
+    if (event == Event::Backspace) {
+        // Drop a whole UTF-8 sequence, not just its last byte
+        while (!search_query_.empty() && (search_query_.back() & 0xC0) == 0x80) {
+            search_query_.pop_back();
         }
-        if (current_focus_ == FocusPane::TICKETS && selected_ticket_ < int(tickets_.size()) - 1) {
-            selected_ticket_++;
-            return true;
+        if (!search_query_.empty()) {
+            search_query_.pop_back();
         }
+        updateSearch();
+        return true;
+    }
+    if (event.is_character()) {
+        search_query_ += event.character();
+        updateSearch();
+        return true;
     }
     
+    // Arrows and function keys keep working while typing
     return false;
 }
 
+void UIManager::updateSearch() {
+    if (search_query_.empty()) {
+        // Stops ticket edits re-running the old query
+        ticket_filter_->setQuery(search_query_);
+        search_ids_.clear();
+        search_pending_ = false;
+        loadTicketRows();
+        return;
+    }
+    search_pending_ = true;
+    ticket_filter_->setQuery(search_query_);
+}
+
+void UIManager::applySearchResults(const std::string& query, std::vector<int> ids) {
+    // A result for a query the user has since changed is dropped; the
+    // newer query is already on its way
+    if (query != search_query_) {
+        return;
+    }
+    search_ids_ = std::move(ids);
+    search_pending_ = false;
+    ticket_window_.selected = 0;
+    ticket_window_.first = 0;
+    loadTicketRows();
+}
+
 void UIManager::toggleFocus() {
     current_focus_ = static_cast<FocusPane>((int(current_focus_) + 1) % 3);
 }
@@ -162,22 +348,20 @@ void UIManager::handleCreateCommand() {
 }
 
 void UIManager::handleEditCommand() {
-    if (current_focus_ == FocusPane::TICKETS && selected_ticket_ >= 0 && selected_ticket_ < int(tickets_.size())) {
+    if (current_focus_ == FocusPane::TICKETS && selectedTicket()) {
         showTicketForm(true);
     }
-    else if (current_focus_ == FocusPane::SPRINTS && selected_sprint_ >= 0 && selected_sprint_ < int(sprints_.size())) {
+    else if (current_focus_ == FocusPane::SPRINTS && sprint_window_.selected < sprints_.size()) {
         showSprintForm(true);
     }
 }
 
 void UIManager::handleDeleteCommand() {
-    if (current_focus_ == FocusPane::TICKETS && selected_ticket_ >= 0 && selected_ticket_ < int(tickets_.size())) {
-        TicketManager::getInstance().deleteTicket(tickets_[selected_ticket_].id);
-        refreshData();
+    if (current_focus_ == FocusPane::TICKETS && selectedTicket()) {
+        TicketManager::getInstance().deleteTicket(selectedTicket()->id);
     }
-    else if (current_focus_ == FocusPane::SPRINTS && selected_sprint_ >= 0 && selected_sprint_ < int(sprints_.size())) {
-        SprintManager::getInstance().deleteSprint(sprints_[selected_sprint_].id);
-        refreshData();
+    else if (current_focus_ == FocusPane::SPRINTS && sprint_window_.selected < sprints_.size()) {
+        SprintManager::getInstance().deleteSprint(sprints_[sprint_window_.selected].id);
     }
 }
 
@@ -189,12 +373,44 @@ void UIManager::handleProjectSwitch() {
     }
     
     // Simple project switching - in real implementation, use a proper dialog
-    if (!projects.empty()) {
-        DatabaseManager::getInstance().switchProject(projects[0]);
-        refreshData();
+    if (!projects.empty() && loading_project_.empty()) {
+        if (DatabaseManager::getInstance().isProjectLoaded(projects[0])) {
+            DatabaseManager::getInstance().switchProject(projects[0]);
+        } else {
+            loadProjectInBackground(projects[0]);
+        }
     }
 }
 
+void UIManager::loadProjectInBackground(const std::string& project_name) {
+    loading_project_ = project_name;
+    load_worker_.post([this, project_name] {
+        // Tickets are decoded here too, so the first frame after the
+        // switch does not do it
+        auto data = std::make_shared<ProjectData>();
+        bool read = false;
+        // Caught here so the completion below is always posted and the
+        // loading state clears
+        try {
+            read = DatabaseManager::getInstance().readProject(project_name, *data, true);
+        } catch (const std::exception& e) {
+            std::cerr << "Error loading project " << project_name << ": " << e.what() << std::endl;
+        }
+        screen_.Post([this, project_name, data, read] {
+            loading_project_.clear();
+            DatabaseManager& db = DatabaseManager::getInstance();
+            // Never replace a copy that was loaded, and maybe edited, meanwhile
+            if (read && !db.isProjectLoaded(project_name)) {
+                db.installProject(project_name, std::move(*data));
+            }
+            if (db.isProjectLoaded(project_name)) {
+                db.switchProject(project_name);
+            }
+        });
+        screen_.PostEvent(Event::Custom);
+    });
+}
+
 void UIManager::handleProjectCreate() {
     showProjectForm();
 }
@@ -261,13 +477,13 @@ ftxui::Component UIManager::makeProjectForm() {
 
 void UIManager::showTicketForm(bool editing) {
     is_editing_ = editing;
-    if (editing && selected_ticket_ >= 0 && selected_ticket_ < int(tickets_.size())) {
-        current_ticket_ = tickets_[selected_ticket_];
+    if (editing && selectedTicket()) {
+        current_ticket_ = *selectedTicket();
     } else {
         current_ticket_ = Ticket();
-        current_ticket_.status = "todo";
-        current_ticket_.priority = "medium";
-        current_ticket_.type = "task";
+        current_ticket_.status = TicketStatus::Todo;
+        current_ticket_.priority = TicketPriority::Medium;
+        current_ticket_.type = TicketType::Task;
     }
 
     story_points_str_ = std::to_string(current_ticket_.story_points);
@@ -282,8 +498,8 @@ void UIManager::showTicketForm(bool editing) {
 
 void UIManager::showSprintForm(bool editing) {
     is_editing_ = editing;
-    if (editing && selected_sprint_ >= 0 && selected_sprint_ < int(sprints_.size())) {
-        current_sprint_ = sprints_[selected_sprint_];
+    if (editing && sprint_window_.selected < sprints_.size()) {
+        current_sprint_ = sprints_[sprint_window_.selected];
     } else {
         current_sprint_ = Sprint();
         current_sprint_.status = "planned";
@@ -318,7 +534,6 @@ void UIManager::submitTicketForm() {
         TicketManager::getInstance().createTicket(current_ticket_);
     }
     closeForms();
-    refreshData();
 }
 
 void UIManager::submitSprintForm() {
@@ -330,14 +545,12 @@ void UIManager::submitSprintForm() {
         SprintManager::getInstance().createSprint(current_sprint_);
     }
     closeForms();
-    refreshData();
 }
 
 void UIManager::submitProjectForm() {
     if (!new_project_name_.empty()) {
         DatabaseManager::getInstance().createNewProject(new_project_name_);
         closeForms();
-        refreshData();
     }
 }
 
@@ -373,18 +586,49 @@ Element UIManager::renderReceiptSeparator() {
 
 /* ========================== Main Rendering ========================== */
 Element UIManager::renderMainLayout() {
+    const auto frame_start = std::chrono::steady_clock::now();
+    const size_t rebuilds_before = sprint_pane_.rebuilds + ticket_pane_.rebuilds + activity_pane_.rebuilds;
+    
+    // Windows follow the terminal height; a new ticket window needs its
+    // rows fetched again
+    sprint_window_.fit(paneRows(kSprintDetailLines), sprints_.size());
+    const size_t ticket_rows = paneRows(kTicketDetailLines);
+    if (ticket_rows != ticket_window_.rows) {
+        ticket_window_.rows = ticket_rows;
+        loadTicketRows();
+    }
+    
+    // Sprint rows show ticket stats and user names too. The sum of the
+    // counters changes whenever one of them does.
+    DatabaseManager& db = DatabaseManager::getInstance();
+    const uint64_t sprint_data = db.getVersion(ChangeEntity::Sprint) + db.getVersion(ChangeEntity::Ticket) +
+                                 db.getVersion(ChangeEntity::User);
+    auto sprints = sprint_pane_.get(
+        ListPaneKey(sprint_data, sprint_window_.selected, sprint_window_.first, sprint_window_.rows,
+                    current_focus_ == FocusPane::SPRINTS),
+        [this] { return renderSprintPane(); });
+    auto tickets = ticket_pane_.get(
+        {ListPaneKey(ticket_rows_version_, ticket_window_.selected, ticket_window_.first, ticket_window_.rows,
+                     current_focus_ == FocusPane::TICKETS),
+         search_query_ + (search_typing_ ? "_" : "") + (search_pending_ ? "." : "")},
+        [this] { return renderTicketPane(); });
+    auto activity = activity_pane_.get(db.getVersion(ChangeEntity::Activity), [this] { return renderActivityPane(); });
+    
     auto main_screen = vbox({
         renderStatusBar(),
         separator() | color(RetroColors::RECEIPT_GREEN),
         hbox({
-            renderSprintPane() | flex,
+            sprints | flex,
             separator() | color(RetroColors::RECEIPT_GREEN),
-            renderTicketPane() | flex,
+            tickets | flex,
         }) | flex,
         separator() | color(RetroColors::RECEIPT_GREEN),
-        renderActivityPane() | size(HEIGHT, EQUAL, 6),
+        activity | size(HEIGHT, EQUAL, 6),
     }) | bgcolor(RetroColors::RECEIPT_BG);
     
+    last_frame_time_ = std::chrono::steady_clock::now() - frame_start;
+    last_frame_rebuilds_ = sprint_pane_.rebuilds + ticket_pane_.rebuilds + activity_pane_.rebuilds - rebuilds_before;
+    
     // Overlay menus
     if (show_menu_) {
         return dbox({
@@ -405,8 +649,26 @@ Element UIManager::renderMainLayout() {
 
 Element UIManager::renderStatusBar() {
     auto left = text(" RETRO-SCRUM v1.0 ") | bold | color(RetroColors::RECEIPT_GREEN);
-    auto center = text("[FOCUS: " + getFocusIndicator(current_focus_) + "]") | color(RetroColors::RECEIPT_AMBER);
-    auto right = text("F1=Help F2=Create F3=Edit F4=Del F5=Refresh F6=SwitchProj F7=NewProj Q=Quit") | color(RetroColors::RECEIPT_GREEN);
+    std::string status = "[FOCUS: " + getFocusIndicator(current_focus_) + "]";
+    if (!loading_project_.empty()) {
+        status += " [LOADING " + loading_project_ + "...]";
+    }
+    
+    // Latency of the last snapshot write, done off this thread
+    SaveStats saves = DatabaseManager::getInstance().getSaveStats();
+    if (saves.saves > 0) {
+        status += " [SAVE " + std::to_string(saves.last_latency.count() / 1000) + "ms" +
+                  (saves.failures > 0 ? " FAILED:" + std::to_string(saves.failures) : "") + "]";
+    }
+    // Shown one frame late: this frame is still being built
+    if (debug_frames_) {
+        char frame[48];
+        std::snprintf(frame, sizeof(frame), " [FRAME %.2fms %zu/3]",
+                      std::chrono::duration<double, std::milli>(last_frame_time_).count(), last_frame_rebuilds_);
+        status += frame;
+    }
+    auto center = text(status) | color(RetroColors::RECEIPT_AMBER);
+    auto right = text("F1=Help F2=Create F3=Edit F4=Del F5=Refresh F6=SwitchProj F7=NewProj /=Search Q=Quit") | color(RetroColors::RECEIPT_GREEN);
     
     return hbox({ 
         left, 
@@ -424,10 +686,13 @@ Element UIManager::renderSprintPane() {
         });
     }
     
+    const size_t selected = sprint_window_.selected;
+    const size_t last = std::min(sprints_.size(), sprint_window_.first + sprint_window_.rows);
+    
     std::vector<Element> rows;
-    rows.push_back(renderReceiptHeader("SPRINTS"));
+    rows.push_back(renderReceiptHeader("SPRINTS (" + std::to_string(selected + 1) + "/" + std::to_string(sprints_.size()) + ")"));
     
-    for (size_t i = 0; i < sprints_.size(); ++i) {
+    for (size_t i = sprint_window_.first; i < last; ++i) {
         const Sprint& s = sprints_[i];
         std::string status_indicator = "○";
         if (s.status == "active") status_indicator = "▶";
@@ -438,14 +703,14 @@ Element UIManager::renderSprintPane() {
             "ID:" + std::to_string(s.id)
         );
         
-        if (static_cast<int>(i) == selected_sprint_ && current_focus_ == FocusPane::SPRINTS) {
+        if (i == selected && current_focus_ == FocusPane::SPRINTS) {
             line = line | inverted | bgcolor(RetroColors::RECEIPT_AMBER) | color(RetroColors::RECEIPT_BG);
         }
         
         rows.push_back(line);
         
         // Add goal if not empty and this sprint is selected
-        if (!s.goal.empty() && static_cast<int>(i) == selected_sprint_) {
+        if (!s.goal.empty() && i == selected) {
             std::string goal = s.goal;
             if (goal.length() > 35) {
                 goal = goal.substr(0, 32) + "...";
@@ -454,11 +719,35 @@ Element UIManager::renderSprintPane() {
         }
         
         // Add date info for selected sprint
-        if (static_cast<int>(i) == selected_sprint_) {
+        if (i == selected) {
             char start_date[11], end_date[11];
             std::strftime(start_date, sizeof(start_date), "%m/%d/%Y", std::localtime(&s.start_date));
             std::strftime(end_date, sizeof(end_date), "%m/%d/%Y", std::localtime(&s.end_date));
             rows.push_back(renderReceiptLine("  Dates: " + std::string(start_date) + " - " + std::string(end_date), ""));
+
+            SprintStats stats = SprintManager::getInstance().getSprintStats(s.id);
+            rows.push_back(renderReceiptLine(
+                "  Points: " + std::to_string(stats.completed_points) + "/" + std::to_string(stats.total_points) + " done",
+                std::to_string(stats.tickets) + " tickets"));
+            auto count = [&stats](TicketStatus status) {
+                return std::to_string(stats.status_counts[static_cast<size_t>(status)]);
+            };
+            rows.push_back(renderReceiptLine(
+                "  Todo " + count(TicketStatus::Todo) + "  Prog " + count(TicketStatus::InProgress) +
+                "  Rev " + count(TicketStatus::Review) + "  Done " + count(TicketStatus::Done), ""));
+
+            // Heaviest open loads
+            std::string load;
+            for (size_t a = 0; a < stats.assignee_load.size() && a < 2; ++a) {
+                const AssigneeLoad& entry = stats.assignee_load[a];
+                auto user = std::find_if(users_.begin(), users_.end(),
+                                         [&entry](const User& u) { return u.id == entry.assignee_id; });
+                std::string name = user != users_.end() ? user->username : "unassigned";
+                load += (load.empty() ? "" : ", ") + name + " " + std::to_string(entry.open_points) + "pt";
+            }
+            if (!load.empty()) {
+                rows.push_back(renderReceiptLine("  Load: " + load, ""));
+            }
         }
     }
     
@@ -468,18 +757,25 @@ Element UIManager::renderSprintPane() {
 }
 
 Element UIManager::renderTicketPane() {
+    std::string header = "TICKETS";
+    if (search_typing_ || !search_query_.empty()) {
+        header += " /" + search_query_ + (search_typing_ ? "_" : "") + (search_pending_ ? " ..." : "");
+    }
+    
     if (tickets_.empty()) {
         return vbox({
-            renderReceiptHeader("TICKETS"),
-            text("│ No tickets available") | color(RetroColors::RECEIPT_WHITE),
+            renderReceiptHeader(header),
+            text(search_query_.empty() ? "│ No tickets available" : "│ No matching tickets") | color(RetroColors::RECEIPT_WHITE),
             text("└────────────────────────────────────────────────────┘") | color(RetroColors::RECEIPT_GREEN)
         });
     }
     
     std::vector<Element> rows;
-    rows.push_back(renderReceiptHeader("TICKETS"));
+    rows.push_back(renderReceiptHeader(header + " (" + std::to_string(ticket_window_.selected + 1) + "/" +
+                                       std::to_string(ticket_count_) + ")"));
     
-    for (size_t i = 0; i < tickets_.size() && i < 15; ++i) {
+    const size_t selected = ticket_window_.selected - ticket_window_.first;
+    for (size_t i = 0; i < tickets_.size(); ++i) {
         const Ticket& t = tickets_[i];
         
         std::string title = t.title;
@@ -488,28 +784,28 @@ Element UIManager::renderTicketPane() {
         }
         
         std::string status_symbol = "○";
-        if (t.status == "in_progress") status_symbol = "▶";
-        if (t.status == "review") status_symbol = "◐";
-        if (t.status == "done") status_symbol = "✓";
+        if (t.status == TicketStatus::InProgress) status_symbol = "▶";
+        if (t.status == TicketStatus::Review) status_symbol = "◐";
+        if (t.status == TicketStatus::Done) status_symbol = "✓";
         
         // Priority indicator
         std::string priority_indicator = "";
-        if (t.priority == "high") priority_indicator = "!";
-        if (t.priority == "critical") priority_indicator = "!!";
+        if (t.priority == TicketPriority::High) priority_indicator = "!";
+        if (t.priority == TicketPriority::Critical) priority_indicator = "!!";
         
         auto line = renderReceiptLine(
             status_symbol + " " + priority_indicator + " #" + std::to_string(t.id) + " " + title,
-            t.status
+            toString(t.status)
         );
         
-        if (static_cast<int>(i) == selected_ticket_ && current_focus_ == FocusPane::TICKETS) {
+        if (i == selected && current_focus_ == FocusPane::TICKETS) {
             line = line | inverted | bgcolor(RetroColors::RECEIPT_AMBER) | color(RetroColors::RECEIPT_BG);
         }
         
         rows.push_back(line);
         
         // Show additional info for selected ticket
-        if (static_cast<int>(i) == selected_ticket_) {
+        if (i == selected) {
             if (t.story_points > 0) {
                 rows.push_back(renderReceiptLine("  Points: " + std::to_string(t.story_points) + " SP", ""));
             }
@@ -562,6 +858,8 @@ Element UIManager::renderMainMenu() {
         text(" NAVIGATION:") | color(RetroColors::RECEIPT_AMBER) | bold,
         text("   Tab        Switch focus between panes") | color(RetroColors::RECEIPT_WHITE),
         text("   ↑↓         Navigate items in focused pane") | color(RetroColors::RECEIPT_WHITE),
+        text("   PgUp/PgDn  Page through focused pane") | color(RetroColors::RECEIPT_WHITE),
+        text("   Home/End   Jump to first/last item") | color(RetroColors::RECEIPT_WHITE),
         text("   F1         Toggle this help menu") | color(RetroColors::RECEIPT_WHITE),
         separator() | color(RetroColors::RECEIPT_AMBER),
         text(" ACTIONS:") | color(RetroColors::RECEIPT_AMBER) | bold,
@@ -570,6 +868,10 @@ Element UIManager::renderMainMenu() {
         text("   F4         Delete selected item") | color(RetroColors::RECEIPT_WHITE),
         text("   F5         Refresh data") | color(RetroColors::RECEIPT_WHITE),
         separator() | color(RetroColors::RECEIPT_AMBER),
+        text(" SEARCH:") | color(RetroColors::RECEIPT_AMBER) | bold,
+        text("   /          Filter tickets as you type") | color(RetroColors::RECEIPT_WHITE),
+        text("   Enter      Keep the filter, ESC clears it") | color(RetroColors::RECEIPT_WHITE),
+        separator() | color(RetroColors::RECEIPT_AMBER),
         text(" PROJECTS:") | color(RetroColors::RECEIPT_AMBER) | bold,
         text("   F6         Switch project") | color(RetroColors::RECEIPT_WHITE),
         text("   F7         Create new project") | color(RetroColors::RECEIPT_WHITE),
@@ -646,6 +948,48 @@ Element UIManager::renderProjectForm() {
 }
 
 /* ========================== Utility Methods ========================== */
+bool UIManager::ListWindow::fit(size_t capacity, size_t count) {
+    const size_t old_first = first;
+    const size_t old_rows = rows;
+    rows = std::max<size_t>(capacity, 1);
+    selected = count == 0 ? 0 : std::min(selected, count - 1);
+    
+    if (selected < first) {
+        first = selected;
+    } else if (selected >= first + rows) {
+        first = selected - rows + 1;
+    }
+    // A shrunk list shouldn't leave blank rows under its last entry
+    if (first + rows > count) {
+        first = count > rows ? count - rows : 0;
+    }
+    return first != old_first || rows != old_rows;
+}
+
+bool UIManager::ListWindow::move(long delta, size_t count) {
+    if (count == 0) {
+        return false;
+    }
+    const long target = long(selected) + delta;
+    selected = size_t(std::clamp(target, 0L, long(count) - 1));
+    return fit(rows, count);
+}
+
+// Rows a list pane can draw at the current terminal height, leaving room
+// for the selected entry's detail lines
+size_t UIManager::paneRows(int detail_lines) const {
+    const int rows = Terminal::Size().dimy - kChromeLines - detail_lines;
+    return rows > 0 ? size_t(rows) : 1;
+}
+
+const Ticket* UIManager::selectedTicket() const {
+    const size_t row = ticket_window_.selected - ticket_window_.first;
+    if (ticket_window_.selected < ticket_window_.first || row >= tickets_.size()) {
+        return nullptr;
+    }
+    return &tickets_[row];
+}
+
 std::string UIManager::formatTime(time_t timestamp) {
     char buf[16];
     std::strftime(buf, sizeof(buf), "%m/%d %H:%M", std::localtime(&timestamp));
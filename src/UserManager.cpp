@@ -22,9 +22,9 @@ UIManager::UIManager()
     
     // Initialize default ticket
     current_ticket_ = Ticket();
-    current_ticket_.status = "todo";
-    current_ticket_.priority = "medium";
-    current_ticket_.type = "task";
+    current_ticket_.status = TicketStatus::Todo;
+    current_ticket_.priority = TicketPriority::Medium;
+    current_ticket_.type = TicketType::Task;
     
     // Initialize default sprint
     current_sprint_ = Sprint();
@@ -264,9 +264,9 @@ void UIManager::showTicketForm(bool editing) {
         current_ticket_ = tickets_[selected_ticket_];
     } else {
         current_ticket_ = Ticket();
-        current_ticket_.status = "todo";
-        current_ticket_.priority = "medium";
-        current_ticket_.type = "task";
+        current_ticket_.status = TicketStatus::Todo;
+        current_ticket_.priority = TicketPriority::Medium;
+        current_ticket_.type = TicketType::Task;
     }
 
     story_points_str_ = std::to_string(current_ticket_.story_points);
@@ -487,18 +487,18 @@ Element UIManager::renderTicketPane() {
         }
         
         std::string status_symbol = "○";
-        if (t.status == "in_progress") status_symbol = "▶";
-        if (t.status == "review") status_symbol = "◐";
-        if (t.status == "done") status_symbol = "✓";
+        if (t.status == TicketStatus::InProgress) status_symbol = "▶";
+        if (t.status == TicketStatus::Review) status_symbol = "◐";
+        if (t.status == TicketStatus::Done) status_symbol = "✓";
         
         // Priority indicator
         std::string priority_indicator = "";
-        if (t.priority == "high") priority_indicator = "!";
-        if (t.priority == "critical") priority_indicator = "!!";
+        if (t.priority == TicketPriority::High) priority_indicator = "!";
+        if (t.priority == TicketPriority::Critical) priority_indicator = "!!";
         
         auto line = renderReceiptLine(
             status_symbol + " " + priority_indicator + " #" + std::to_string(t.id) + " " + title,
-            t.status
+            toString(t.status)
         );
         
         if (static_cast<int>(i) == selected_ticket_ && current_focus_ == FocusPane::TICKETS) {
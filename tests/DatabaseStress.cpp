@@ -0,0 +1,186 @@
+//DatabaseStress.cpp
+// Readers query the current project while a writer edits it and makes the
+// calls that save under their own write lock (project creation, format
+// changes, imports). A save awaited under a lock throws std::logic_error,
+// and any reader that sees a half-made write fails its checks. Exits
+// non-zero on the first failure.
+#include "DatabaseManager.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::atomic<int> failures{0};
+
+    void check(bool condition, const char* what)
+    {
+        if (!condition && failures.fetch_add(1) < 10)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+        }
+    }
+
+    void fillProject(DatabaseManager& db, const std::string& prefix, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            Ticket ticket;
+            ticket.title = prefix + " " + std::to_string(i);
+            ticket.status = static_cast<TicketStatus>(i % 4);
+            ticket.story_points = i % 8;
+            db.createTicket(ticket);
+        }
+    }
+
+    void readLoop(DatabaseManager& db, int kind, const std::atomic<bool>& stop,
+                  std::atomic<long>& reads, std::atomic<long>& slowest_ms)
+    {
+        while (!stop)
+        {
+            auto started = std::chrono::steady_clock::now();
+            switch (kind)
+            {
+            case 0:
+            {
+                auto tickets = db.queryTickets(TicketQuery().status(TicketStatus::Todo).limit(20));
+                for (const auto& ticket : tickets)
+                {
+                    check(ticket.status == TicketStatus::Todo, "status query returned another status");
+                }
+                break;
+            }
+            case 1:
+            {
+                auto tickets = db.searchTicketsSubstring("alpha 1", 50);
+                for (const auto& ticket : tickets)
+                {
+                    check(ticket.title.find("alpha 1") != std::string::npos, "substring search returned a miss");
+                }
+                break;
+            }
+            case 2:
+            {
+                auto tickets = db.getTicketsInRange(0, 50);
+                for (size_t i = 1; i < tickets.size(); ++i)
+                {
+                    check(tickets[i - 1].id < tickets[i].id, "ticket list out of insertion order");
+                }
+                break;
+            }
+            default:
+            {
+                ProjectSnapshot snapshot = db.takeSnapshot();
+                size_t seen = 0;
+                snapshot.tickets().forEach([&seen](const Ticket&) { ++seen; return true; });
+                check(seen == snapshot.tickets().size(), "snapshot changed while read");
+                break;
+            }
+            }
+            long took = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - started).count());
+            long slowest = slowest_ms.load();
+            while (took > slowest && !slowest_ms.compare_exchange_weak(slowest, took))
+            {
+            }
+            ++reads;
+        }
+    }
+}
+
+int main()
+{
+    // Projects are kept relative to the working directory
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "retro-scrum-stress";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::current_path(directory);
+
+    DatabaseManager& db = DatabaseManager::getInstance();
+    db.initialize();
+    check(db.createNewProject("alpha"), "createNewProject(alpha)");
+    fillProject(db, "alpha", 2000);
+    check(db.exportProjectJson("alpha", "alpha.json"), "exportProjectJson(alpha)");
+
+    std::atomic<bool> stop{false};
+    std::atomic<long> reads{0};
+    std::atomic<long> slowest_ms{0};
+    std::vector<std::thread> readers;
+    for (int kind = 0; kind < 4; ++kind)
+    {
+        readers.emplace_back(readLoop, std::ref(db), kind, std::cref(stop), std::ref(reads), std::ref(slowest_ms));
+    }
+
+    const SnapshotFormat formats[] = { SnapshotFormat::Json, SnapshotFormat::Segmented, SnapshotFormat::Binary };
+    try
+    {
+        for (int i = 0; i < 600; ++i)
+        {
+            Ticket ticket;
+            ticket.title = "alpha w" + std::to_string(i);
+            db.createTicket(ticket);
+            ticket.status = TicketStatus::Done;
+            db.updateTicket(ticket);
+            if (i % 3 == 0)
+            {
+                db.deleteTicket(ticket.id);
+            }
+
+            // Each of these saves under its own write lock
+            if (i % 50 == 10)
+            {
+                check(db.setProjectFormat("alpha", formats[(i / 50) % 3]), "setProjectFormat(alpha)");
+            }
+            if (i % 100 == 30)
+            {
+                std::string name = "beta" + std::to_string(i);
+                check(db.createNewProject(name), "createNewProject(beta)");
+                check(db.switchProject("alpha"), "switchProject(alpha)");
+            }
+            if (i % 100 == 70)
+            {
+                check(db.importProjectJson("gamma" + std::to_string(i), "alpha.json"), "importProjectJson(gamma)");
+            }
+            if (i % 100 == 90)
+            {
+                check(db.saveProject("alpha"), "saveProject(alpha)");
+            }
+        }
+    }
+    catch (const std::exception& error)
+    {
+        check(false, error.what());
+    }
+
+    stop = true;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    check(reads > 0, "readers made no progress");
+
+    // Reload round trip over several ticket segments, whose files the
+    // directory may list in any order
+    const int reload_tickets = 5000;
+    check(db.createNewProject("delta"), "createNewProject(delta)");
+    fillProject(db, "delta", reload_tickets);
+    for (SnapshotFormat format : formats)
+    {
+        check(db.setProjectFormat("delta", format), "setProjectFormat(delta)");
+        ProjectData reloaded;
+        check(db.readProject("delta", reloaded, true), "readProject(delta)");
+        check(reloaded.tickets.size() == static_cast<size_t>(reload_tickets), "reloaded ticket count");
+        check(std::is_sorted(reloaded.tickets.begin(), reloaded.tickets.end(),
+                             [](const Ticket& a, const Ticket& b) { return a.id < b.id; }),
+              "reloaded tickets out of insertion order");
+    }
+    std::cout << reads << " reads, slowest " << slowest_ms << " ms" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
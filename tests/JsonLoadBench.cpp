@@ -0,0 +1,152 @@
+//JsonLoadBench.cpp
+// Peak memory of loading a large JSON snapshot through the old DOM path
+// (parse into nlohmann::json, then get<>() every section) and through
+// JsonSnapshotReader's SAX path. Each load runs in its own process, started
+// from this one, so ru_maxrss covers that load alone. Exits non-zero if the
+// SAX load does not peak lower.
+#include "DatabaseManager.hpp"
+#include "JsonSnapshotReader.hpp"
+#include <sys/resource.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    using json = nlohmann::json;
+
+    void writeProject(const std::string& path, int tickets)
+    {
+        json project_data;
+        std::vector<User> users;
+        for (int i = 1; i <= 200; ++i)
+        {
+            User user("user" + std::to_string(i), "password", "user");
+            user.id = i;
+            users.push_back(user);
+        }
+        std::vector<Sprint> sprints;
+        for (int i = 1; i <= 50; ++i)
+        {
+            Sprint sprint;
+            sprint.id = i;
+            sprint.name = "Sprint " + std::to_string(i);
+            sprints.push_back(sprint);
+        }
+        std::vector<Ticket> rows;
+        for (int i = 1; i <= tickets; ++i)
+        {
+            Ticket ticket;
+            ticket.id = i;
+            ticket.title = "Ticket " + std::to_string(i);
+            ticket.description = std::string(160, 'a' + i % 26);
+            ticket.sprint_id = i % 50 + 1;
+            ticket.assignee_id = i % 200 + 1;
+            ticket.story_points = i % 13;
+            rows.push_back(ticket);
+        }
+        std::vector<Activity> activities;
+        for (int i = 1; i <= tickets / 4; ++i)
+        {
+            Activity activity;
+            activity.id = i;
+            activity.ticket_id = i;
+            activity.action = "created";
+            activity.description = "Created ticket " + std::to_string(i);
+            activities.push_back(activity);
+        }
+
+        project_data["users"] = users;
+        project_data["tickets"] = rows;
+        project_data["sprints"] = sprints;
+        project_data["activities"] = activities;
+        project_data["next_ids"] = {
+            {"user", 201},
+            {"ticket", tickets + 1},
+            {"sprint", 51},
+            {"activity", tickets / 4 + 1}
+        };
+        std::ofstream(path) << project_data.dump(4);
+    }
+
+    // The loader as it was before the SAX reader
+    bool loadDom(const std::string& path, ProjectData& data)
+    {
+        std::ifstream file(path);
+        json project_data;
+        file >> project_data;
+        data.users = project_data["users"].get<std::vector<User>>();
+        data.tickets = project_data["tickets"].get<std::vector<Ticket>>();
+        data.sprints = project_data["sprints"].get<std::vector<Sprint>>();
+        data.activities.assign(project_data["activities"].get<std::vector<Activity>>());
+        return true;
+    }
+
+    bool loadSax(const std::string& path, ProjectData& data)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::string error;
+        return JsonSnapshotReader::read(file, data, error);
+    }
+
+    long peakKilobytes()
+    {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    // Runs this program again as "<self> <mode> <path>" and reads back the
+    // peak it reports
+    long measure(const std::string& self, const std::string& mode, const std::string& path)
+    {
+        std::string command = "\"" + self + "\" " + mode + " \"" + path + "\"";
+        FILE* child = popen(command.c_str(), "r");
+        if (!child)
+        {
+            return -1;
+        }
+        long peak = -1;
+        if (std::fscanf(child, "%ld", &peak) != 1)
+        {
+            peak = -1;
+        }
+        return pclose(child) == 0 ? peak : -1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 3)
+    {
+        ProjectData data;
+        std::string mode = argv[1];
+        bool loaded = mode == "dom" ? loadDom(argv[2], data) : loadSax(argv[2], data);
+        if (!loaded || data.tickets.empty())
+        {
+            return 1;
+        }
+        std::cout << peakKilobytes() << std::endl;
+        return 0;
+    }
+
+    const int kTickets = 200000;
+    std::string path = (std::filesystem::temp_directory_path() / "retro-scrum-load-bench.json").string();
+    writeProject(path, kTickets);
+    std::string self = std::filesystem::absolute(argv[0]).string();
+
+    long dom = measure(self, "dom", path);
+    long sax = measure(self, "sax", path);
+    std::cout << kTickets << " tickets, " << std::filesystem::file_size(path) / 1024
+              << " KB on disk; peak RSS: DOM " << dom << " KB, SAX " << sax << " KB" << std::endl;
+    std::filesystem::remove(path);
+
+    if (dom <= 0 || sax <= 0 || sax >= dom)
+    {
+        std::cerr << "FAILED: SAX load did not peak below the DOM load" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+//LookupBench.cpp
+// Point reads, updates and deletes by id through DatabaseManager at 10k,
+// 100k and 1M tickets, next to what they cost before the id -> slot
+// indexes: a find_if scan per lookup and an in-place vector erase per
+// delete. Each project is imported from a generated JSON snapshot. Exits
+// non-zero if a lookup, delete or the list after it comes back wrong.
+#include "DatabaseManager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using json = nlohmann::json;
+
+    int failures = 0;
+
+    void check(bool condition, const char* what)
+    {
+        if (!condition && failures++ < 10)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+        }
+    }
+
+    // Streams one record at a time, so the generator never holds the whole
+    // document
+    void writeProject(const std::string& path, int tickets)
+    {
+        std::ofstream out(path);
+        User admin("admin", "password", "admin");
+        admin.id = 1;
+        out << "{\"users\":[" << json(admin).dump() << "],\"sprints\":[],\"activities\":[],\"tickets\":[";
+        for (int i = 1; i <= tickets; ++i)
+        {
+            Ticket ticket;
+            ticket.id = i;
+            ticket.title = "Ticket " + std::to_string(i);
+            ticket.sprint_id = i % 50;
+            ticket.story_points = i % 13;
+            out << (i > 1 ? "," : "") << json(ticket).dump();
+        }
+        out << "],\"next_ids\":{\"user\":2,\"ticket\":" << tickets + 1 << ",\"sprint\":1,\"activity\":1}}";
+    }
+
+    template <typename Run>
+    double microsecondsPerOp(Run&& run, size_t ops)
+    {
+        auto started = std::chrono::steady_clock::now();
+        run();
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - started;
+        return elapsed.count() / static_cast<double>(ops);
+    }
+
+    void benchmark(DatabaseManager& db, int tickets)
+    {
+        const std::string name = "lookup" + std::to_string(tickets);
+        const std::string path = name + ".json";
+        writeProject(path, tickets);
+        check(db.importProjectJson(name, path), "importProjectJson");
+        check(db.switchProject(name), "switchProject");
+        std::filesystem::remove(path);
+
+        std::mt19937 random(static_cast<unsigned>(tickets));
+        std::uniform_int_distribution<int> any_id(1, tickets);
+        std::vector<int> ids(100000);
+        for (int& id : ids)
+        {
+            id = any_id(random);
+        }
+
+        // Before: every lookup scanned the rows
+        std::vector<Ticket> rows = db.getAllTickets();
+        const size_t scans = 200;
+        long long sink = 0;
+        double scan = microsecondsPerOp([&] {
+            for (size_t i = 0; i < scans; ++i)
+            {
+                const int id = ids[i];
+                auto it = std::find_if(rows.begin(), rows.end(), [id](const Ticket& t) { return t.id == id; });
+                sink += it != rows.end() ? it->story_points : 0;
+            }
+        }, scans);
+
+        bool found = true;
+        double lookup = microsecondsPerOp([&] {
+            for (int id : ids)
+            {
+                Ticket ticket = db.getTicket(id);
+                found = found && ticket.id == id;
+                sink += ticket.story_points;
+            }
+        }, ids.size());
+        check(found, "getTicket missed an id");
+
+        // Updates and deletes also journal each edit
+        const size_t edits = 1000;
+        double update = microsecondsPerOp([&] {
+            for (size_t i = 0; i < edits; ++i)
+            {
+                Ticket ticket = db.getTicket(ids[i]);
+                ticket.story_points += 1;
+                db.updateTicket(ticket);
+            }
+        }, edits);
+
+        // Before: a delete erased its row in place and moved every later one
+        const size_t erases = 100;
+        double shift = microsecondsPerOp([&] {
+            for (size_t i = 0; i < erases; ++i)
+            {
+                rows.erase(rows.begin() + static_cast<std::ptrdiff_t>(ids[i] % rows.size()));
+            }
+        }, erases);
+
+        std::vector<int> doomed(ids.begin(), ids.begin() + edits);
+        std::sort(doomed.begin(), doomed.end());
+        doomed.erase(std::unique(doomed.begin(), doomed.end()), doomed.end());
+        std::shuffle(doomed.begin(), doomed.end(), random);
+        double erase = microsecondsPerOp([&] {
+            for (int id : doomed)
+            {
+                db.deleteTicket(id);
+            }
+        }, doomed.size());
+
+        // The first read that walks the tickets pays for squeezing the
+        // deletes out
+        std::vector<Ticket> page;
+        double first_read = microsecondsPerOp([&] { page = db.getTicketsInRange(0, 50); }, 1);
+        check(page.size() == 50, "first page short after deletes");
+
+        const size_t live = static_cast<size_t>(tickets) - doomed.size();
+        check(db.getTicketCount() == live, "ticket count after deletes");
+        check(db.getTicket(doomed.front()).id == 0, "deleted ticket still found");
+        std::vector<Ticket> all = db.getTicketsInRange(0, static_cast<size_t>(tickets));
+        check(all.size() == live, "ticket list size after deletes");
+        check(std::is_sorted(all.begin(), all.end(), [](const Ticket& a, const Ticket& b) { return a.id < b.id; }),
+              "ticket list out of insertion order after deletes");
+        for (size_t i = 0; i < all.size(); i += all.size() / 100 + 1)
+        {
+            check(db.getTicket(all[i].id).id == all[i].id, "getTicket missed an id after deletes");
+        }
+
+        std::cout << tickets << " tickets, us per op: scan lookup " << scan << ", getTicket " << lookup
+                  << ", updateTicket " << update << ", vector erase " << shift << ", deleteTicket " << erase
+                  << "; first read after " << doomed.size() << " deletes " << first_read / 1000.0 << " ms"
+                  << " (checksum " << sink << ")" << std::endl;
+    }
+}
+
+int main()
+{
+    // Projects are kept relative to the working directory
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "retro-scrum-lookup";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::current_path(directory);
+
+    DatabaseManager& db = DatabaseManager::getInstance();
+    db.initialize();
+    db.setLazyLoading(false);
+    // Keeps the timed edits clear of the periodic snapshot rewrite
+    db.setJournalCompactionThreshold(1000000);
+    for (int tickets : { 10000, 100000, 1000000 })
+    {
+        benchmark(db, tickets);
+    }
+    return failures == 0 ? 0 : 1;
+}
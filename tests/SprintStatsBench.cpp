@@ -0,0 +1,151 @@
+//SprintStatsBench.cpp
+// Checks that the AVX2 and scalar sprint statistics kernels agree, story
+// points at the limits of int included, then times both against the naive
+// loop over ticket rows at 1M tickets. Exits non-zero if any result differs.
+#include "SprintStats.hpp"
+#include "TicketColumns.hpp"
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, const char* what)
+    {
+        if (!condition)
+        {
+            ++failures;
+            std::cerr << "FAILED: " << what << std::endl;
+        }
+    }
+
+    std::vector<Ticket> makeTickets(size_t count, bool extreme_points)
+    {
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> sprint(1, 20);
+        std::uniform_int_distribution<int> status(0, static_cast<int>(kTicketStatusCount) - 1);
+        std::uniform_int_distribution<int> assignee(0, 200);
+        std::uniform_int_distribution<int> points(0, 13);
+        std::uniform_int_distribution<int> any_int(INT_MIN, INT_MAX);
+
+        std::vector<Ticket> tickets(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Ticket& ticket = tickets[i];
+            ticket.id = static_cast<int>(i) + 1;
+            ticket.sprint_id = sprint(random);
+            ticket.status = static_cast<TicketStatus>(status(random));
+            ticket.assignee_id = assignee(random);
+            ticket.story_points = extreme_points ? (i % 2 ? INT_MAX : any_int(random)) : points(random);
+        }
+        return tickets;
+    }
+
+    // What a caller without the engine would write: one pass over the rows
+    SprintStats naiveStats(const std::vector<Ticket>& tickets, int sprint_id)
+    {
+        SprintStats stats;
+        stats.sprint_id = sprint_id;
+        std::map<int, AssigneeLoad> load;
+        for (const auto& ticket : tickets)
+        {
+            if (ticket.sprint_id != sprint_id)
+            {
+                continue;
+            }
+            ++stats.tickets;
+            stats.total_points += ticket.story_points;
+            if (ticket.status == TicketStatus::Done)
+            {
+                stats.completed_points += ticket.story_points;
+            }
+            ++stats.status_counts[static_cast<size_t>(ticket.status)];
+            AssigneeLoad& entry = load[ticket.assignee_id];
+            entry.assignee_id = ticket.assignee_id;
+            ++entry.tickets;
+            entry.open_points += ticket.status != TicketStatus::Done ? ticket.story_points : 0;
+        }
+        for (const auto& entry : load)
+        {
+            stats.assignee_load.push_back(entry.second);
+        }
+        return stats;
+    }
+
+    bool sameTotals(const SprintStats& a, const SprintStats& b)
+    {
+        return a.tickets == b.tickets && a.total_points == b.total_points &&
+               a.completed_points == b.completed_points && a.status_counts == b.status_counts;
+    }
+
+    bool sameStats(const SprintStats& a, const SprintStats& b)
+    {
+        if (!sameTotals(a, b) || a.assignee_load.size() != b.assignee_load.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.assignee_load.size(); ++i)
+        {
+            const AssigneeLoad& x = a.assignee_load[i];
+            const AssigneeLoad& y = b.assignee_load[i];
+            if (x.assignee_id != y.assignee_id || x.tickets != y.tickets || x.open_points != y.open_points)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Run>
+    double millisecondsPerRun(Run&& run, int runs)
+    {
+        auto started = std::chrono::steady_clock::now();
+        for (int i = 0; i < runs; ++i)
+        {
+            run();
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - started;
+        return elapsed.count() / runs;
+    }
+}
+
+int main()
+{
+    // An odd count leaves a tail for the vector kernel's scalar loop
+    const size_t kTickets = 1000003;
+    std::cout << "kernel: " << SprintStatsEngine::kernelName() << std::endl;
+
+    for (bool extreme_points : { false, true })
+    {
+        std::vector<Ticket> tickets = makeTickets(kTickets, extreme_points);
+        TicketColumns columns;
+        columns.assign(tickets);
+        for (int sprint_id : { 1, 7, 20, 99 })
+        {
+            SprintStats vector = SprintStatsEngine::compute(columns, sprint_id);
+            check(sameStats(vector, SprintStatsEngine::computeScalar(columns, sprint_id)),
+                  extreme_points ? "kernels differ on extreme story points" : "kernels differ");
+            check(sameTotals(vector, naiveStats(tickets, sprint_id)),
+                  extreme_points ? "naive loop differs on extreme story points" : "naive loop differs");
+        }
+    }
+
+    std::vector<Ticket> tickets = makeTickets(kTickets, false);
+    TicketColumns columns;
+    columns.assign(tickets);
+    const int kRuns = 20;
+    int64_t sink = 0;
+    double naive = millisecondsPerRun([&] { sink += naiveStats(tickets, 7).total_points; }, kRuns);
+    double scalar = millisecondsPerRun([&] { sink += SprintStatsEngine::computeScalar(columns, 7).total_points; }, kRuns);
+    double engine = millisecondsPerRun([&] { sink += SprintStatsEngine::compute(columns, 7).total_points; }, kRuns);
+    std::cout << kTickets << " tickets, ms per sprint: naive " << naive << ", scalar " << scalar
+              << ", " << SprintStatsEngine::kernelName() << " " << engine
+              << " (checksum " << sink << ")" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}